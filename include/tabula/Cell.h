@@ -1,12 +1,23 @@
 #pragma once
 #include "tabula/RectangularTextContainer.h"
 #include "tabula/TextChunk.h"
+#include "tabula/TextStore.h"
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace tabula {
 
+// A cell's words either live in its own TextChunks (addTextChunk,
+// setTextElements) or, as the extractors produce them, as a range of a
+// shared TextStore with one element per word. The second form makes cells
+// cheap to copy: placing them in tables and rows copies a pointer and a
+// range, not the text.
+//
+// The text itself is assembled once, on the first text() call, and kept
+// until the words change; Table::getRows() does this for every cell so
+// writers and diagnostics read the same string however often they ask.
 class Cell : public RectangularTextContainer<TextChunk> {
 public:
   Cell(float top, float left, float width, float height)
@@ -16,47 +27,215 @@ public:
       : RectangularTextContainer<TextChunk>(), spanning(false),
         placeholder(false) {}
 
-  void addTextChunk(const TextChunk &tc) { this->textElements.push_back(tc); }
+  void addTextChunk(const TextChunk &tc) {
+    detach();
+    this->textElements.push_back(tc);
+    textCached = false;
+  }
+
+  // The words are elements [words.begin, words.end) of `store`.
+  void setText(std::shared_ptr<const TextStore> store,
+               TextStore::Range words) {
+    this->textElements.clear();
+    textStore = std::move(store);
+    textRange = words;
+    wordsChanged();
+  }
+  const TextStore *getTextStore() const { return textStore.get(); }
+  TextStore::Range getTextRange() const { return textRange; }
+
+  // The words as TextChunks; store-backed cells build them on first use and
+  // keep them until the words change.
+  const std::vector<TextChunk> &getTextElements() const override {
+    if (!textStore)
+      return this->textElements;
+    if (!storeChunksBuilt) {
+      storeChunks.clear();
+      materialize(storeChunks);
+      storeChunksBuilt = true;
+    }
+    return storeChunks;
+  }
+  // Editable chunks; a store-backed cell copies its words out first.
+  std::vector<TextChunk> &getTextElements() override {
+    detach();
+    textCached = false;
+    return this->textElements;
+  }
+  void setTextElements(const std::vector<TextChunk> &v) override {
+    textStore.reset();
+    this->textElements = v;
+    wordsChanged();
+  }
+
+  // Table::add merges cells that land on the same slot; other's words go
+  // after this cell's.
+  void mergeInPlace(const Cell &other) {
+    Rectangle::merge(other);
+    wordsChanged();
+    if (!other.textStore) {
+      if (!other.textElements.empty()) {
+        detach();
+        this->textElements.insert(this->textElements.end(),
+                                  other.textElements.begin(),
+                                  other.textElements.end());
+      }
+      return;
+    }
+    if (!textStore && this->textElements.empty()) {
+      textStore = other.textStore;
+      textRange = other.textRange;
+    } else if (textStore == other.textStore &&
+               textRange.end == other.textRange.begin) {
+      textRange.end = other.textRange.end;
+    } else {
+      detach();
+      other.materialize(this->textElements);
+    }
+  }
+  void mergeInPlace(const RectangularTextContainer<TextChunk> &other) override {
+    if (const Cell *cell = dynamic_cast<const Cell *>(&other)) {
+      mergeInPlace(*cell);
+      return;
+    }
+    Rectangle::merge(other);
+    wordsChanged();
+    const std::vector<TextChunk> &chunks = other.getTextElements();
+    if (!chunks.empty()) {
+      detach();
+      this->textElements.insert(this->textElements.end(), chunks.begin(),
+                                chunks.end());
+    }
+  }
+  RectangularTextContainer<TextChunk> &
+  merge(const RectangularTextContainer<TextChunk> &other) override {
+    mergeInPlace(other);
+    return *this;
+  }
+  using RectangularTextContainer<TextChunk>::merge;
+
+  // getText(true), assembled on first use and cached.
+  const std::string &text() const {
+    if (!textCached) {
+      cachedText.clear();
+      assembleText(true, cachedText);
+      textCached = true;
+    }
+    return cachedText;
+  }
 
   // port of getText(useLineReturns=true) from Java
   std::string getText(bool useLineReturns) const {
-    if (this->textElements.empty())
-      return std::string();
-    // work on a local copy to preserve const-correctness
-    std::vector<TextChunk> copy = this->textElements;
-    std::sort(copy.begin(), copy.end(),
-              [](TextChunk const &a, TextChunk const &b) {
-                if (a.getTop() != b.getTop())
-                  return a.getTop() < b.getTop();
-                return a.getLeft() < b.getLeft();
-              });
+    if (useLineReturns)
+      return text();
     std::string out;
-    float curTop = copy.front().getTop();
-    for (auto const &tc : copy) {
-      if (useLineReturns && tc.getTop() > curTop) {
-        out.push_back('\r');
-      }
-      out += tc.getText();
-      curTop = tc.getTop();
-    }
-    // trim whitespace from both ends
-    auto lpos = out.find_first_not_of(" \t\n\r");
-    if (lpos == std::string::npos)
-      return std::string();
-    auto rpos = out.find_last_not_of(" \t\n\r");
-    return out.substr(lpos, rpos - lpos + 1);
+    assembleText(false, out);
+    return out;
   }
 
-  std::string getText() const { return getText(true); }
+  std::string getText() const { return text(); }
 
   bool isSpanning() const { return spanning; }
   void setSpanning(bool s) { spanning = s; }
+  // Grid rows and columns covered from the cell's slot; 1 x 1 unless
+  // TableWithRulingLines found it spanning ruling lines.
+  int getRowSpan() const { return rowSpan; }
+  int getColSpan() const { return colSpan; }
+  void setSpan(int rows, int cols) {
+    rowSpan = rows;
+    colSpan = cols;
+    spanning = rows > 1 || cols > 1;
+  }
   bool isPlaceholder() const { return placeholder; }
   void setPlaceholder(bool p) { placeholder = p; }
 
 private:
+  std::shared_ptr<const TextStore> textStore;
+  TextStore::Range textRange = TextStore::Range{0, 0};
   bool spanning;
   bool placeholder;
+  int rowSpan = 1;
+  int colSpan = 1;
+  mutable std::string cachedText;
+  mutable bool textCached = false;
+  // getTextElements() of a store-backed cell
+  mutable std::vector<TextChunk> storeChunks;
+  mutable bool storeChunksBuilt = false;
+
+  void wordsChanged() {
+    textCached = false;
+    storeChunks.clear();
+    storeChunksBuilt = false;
+  }
+
+  void materialize(std::vector<TextChunk> &out) const {
+    out.reserve(out.size() + textRange.size());
+    for (uint32_t id = textRange.begin; id < textRange.end; ++id)
+      out.push_back(TextChunk(textStore->element(id)));
+  }
+
+  // Turns a store-backed cell into one owning its chunks.
+  void detach() {
+    if (!textStore)
+      return;
+    if (this->textElements.empty()) {
+      if (storeChunksBuilt)
+        this->textElements.swap(storeChunks);
+      else
+        materialize(this->textElements);
+    }
+    textStore.reset();
+    storeChunks.clear();
+    storeChunksBuilt = false;
+  }
+
+  // Words sorted by top, then left, separated by '\r' where a new line
+  // starts, then trimmed. The sort works on ids or pointers and the text is
+  // appended straight into `out`, whichever form the words are in.
+  void assembleText(bool useLineReturns, std::string &out) const {
+    if (textStore) {
+      storeText(useLineReturns, out);
+    } else if (!this->textElements.empty()) {
+      std::vector<const TextChunk *> order = sortedElements();
+      float curTop = order.front()->getTop();
+      for (const TextChunk *tc : order) {
+        if (useLineReturns && tc->getTop() > curTop)
+          out.push_back('\r');
+        for (const auto &te : tc->getTextElements()) {
+          const TextView v = te.getTextView();
+          out.append(v.data(), v.size());
+        }
+        curTop = tc->getTop();
+      }
+    }
+    trimText(out);
+  }
+
+  void storeText(bool useLineReturns, std::string &out) const {
+    if (textRange.empty())
+      return;
+    const TextStore &s = *textStore;
+    std::vector<uint32_t> order;
+    order.reserve(textRange.size());
+    for (uint32_t id = textRange.begin; id < textRange.end; ++id)
+      order.push_back(id);
+    std::sort(order.begin(), order.end(), [&s](uint32_t a, uint32_t b) {
+      if (s.box(a).top != s.box(b).top)
+        return s.box(a).top < s.box(b).top;
+      return s.box(a).left < s.box(b).left;
+    });
+    size_t bytes = textRange.size();
+    for (uint32_t id : order)
+      bytes += s.textLength(id);
+    out.reserve(out.size() + bytes);
+    float curTop = s.box(order.front()).top;
+    for (uint32_t id : order) {
+      if (useLineReturns && s.box(id).top > curTop)
+        out.push_back('\r');
+      out.append(s.textData(id), s.textLength(id));
+      curTop = s.box(id).top;
+    }
+  }
 };
 
 } // namespace tabula
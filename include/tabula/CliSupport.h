@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <set>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace tabula {
+namespace cli {
+
+// Read a batch manifest: one PDF path per line, trimmed. Blank lines and
+// lines starting with '#' are ignored. The file overload returns false when
+// the manifest cannot be opened.
+void readManifest(std::istream &in, std::vector<std::string> &paths);
+bool readManifest(const std::string &file, std::vector<std::string> &paths);
+
+// Per-document output file inside `dir`: the PDF's base name with the
+// format's extension ("stdin" for "-"), renamed base-2, base-3, ... when an
+// earlier input in `used` already took the base name.
+std::string outputFileFor(const std::string &dir, const std::string &path,
+                          const std::string &ext, std::set<std::string> &used);
+
+// Parses a --threads value: a non-negative decimal integer, 0 meaning one
+// worker per hardware thread. Returns false (leaving `threads` alone) for
+// anything else, negative or out-of-range values included.
+bool parseThreads(const std::string &spec, int &threads);
+
+// Forwards everything to another stream buffer, counting the bytes written.
+class CountingStreambuf : public std::streambuf {
+public:
+  explicit CountingStreambuf(std::streambuf *dest) : dest_(dest), count_(0) {}
+  uint64_t count() const { return count_; }
+
+protected:
+  int_type overflow(int_type c) override;
+  std::streamsize xsputn(const char *s, std::streamsize n) override;
+  int sync() override { return dest_->pubsync(); }
+
+private:
+  std::streambuf *dest_;
+  uint64_t count_;
+};
+
+} // namespace cli
+} // namespace tabula
@@ -8,8 +8,29 @@ namespace tabula {
 // verbose debugging is desired.
 extern bool diagnostics_enabled;
 
+// Building with -DTABULA_NO_DIAGNOSTICS (`make NODIAG=1`) makes this a
+// constant false, so every diagnostic and the work guarded by it is
+// compiled out.
+inline bool diagnosticsEnabled() {
+#ifdef TABULA_NO_DIAGNOSTICS
+  return false;
+#else
+  return diagnostics_enabled;
+#endif
+}
+
 inline void diag(const std::string &s) {
-  if (diagnostics_enabled) std::cerr << s << std::endl;
+  if (diagnosticsEnabled()) std::cerr << s << std::endl;
 }
 
 } // namespace tabula
+
+// Emit a diagnostic line. The message expression (string concatenation,
+// std::to_string, ...) is only evaluated when diagnostics are enabled; guard
+// larger diagnostic-only work such as per-cell dumps with
+// `if (tabula::diagnosticsEnabled()) { ... }`.
+#define TABULA_DIAG(msg)                                                       \
+  do {                                                                         \
+    if (::tabula::diagnosticsEnabled())                                        \
+      ::tabula::diag(msg);                                                     \
+  } while (0)
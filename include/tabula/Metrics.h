@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace tabula {
+
+// Process-wide extraction metrics: counters plus histograms of per-stage
+// latency and per-page text element counts, dumped in Prometheus text
+// format. Collection is off by default; the pipeline checks enabled() before
+// recording anything. Stage latencies come from TraceScope spans.
+class Metrics {
+public:
+  enum Counter {
+    PagesProcessed,
+    TextElements,
+    RulingsBeforeCollapse,
+    RulingsAfterCollapse,
+    IntersectionsTested,
+    CellsFound,
+    TablesEmitted,
+    BytesWritten,
+    CounterCount
+  };
+
+  // Reset all values and start collecting.
+  static void start();
+  static void stop();
+  static bool enabled();
+  static void reset();
+
+  static void add(Counter c, uint64_t n = 1);
+  static uint64_t value(Counter c);
+  // Latency of one run of a pipeline stage (a TraceScope name).
+  static void observeStage(const char *stage, double seconds);
+  static void observeTextElementsPerPage(uint64_t n);
+  // Number of observations recorded for `stage` so far.
+  static uint64_t stageCount(const std::string &stage);
+
+  static void writePrometheus(std::ostream &out);
+  static bool writePrometheus(const std::string &path);
+};
+
+} // namespace tabula
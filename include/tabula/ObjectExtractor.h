@@ -3,6 +3,7 @@
 #include "tabula/Page.h"
 #include "tabula/TextElement.h"
 #include "tabula/TextStripper.h"
+#include <memory>
 #include <vector>
 
 // Simple test-oriented ObjectExtractor: holds an engine and a set of text
@@ -25,11 +26,16 @@ public:
 
   void setEngine(ObjectExtractorStreamEngine *e) { engine_ = e; }
   void setTextElements(const std::vector<TextElement> &e) { elements_ = e; }
+  // Arena the elements' text lives in; handed on to every extracted Page.
+  void setTextArena(std::shared_ptr<const TextArena> arena) {
+    arena_ = std::move(arena);
+  }
 
 private:
   ObjectExtractorStreamEngine *engine_;
   TextStripper stripper_;
   std::vector<TextElement> elements_;
+  std::shared_ptr<const TextArena> arena_;
 };
 
 } // namespace tabula
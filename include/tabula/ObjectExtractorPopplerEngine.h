@@ -1,21 +1,27 @@
 #pragma once
-#ifdef HAVE_POPPLER
 #include "tabula/ObjectExtractorStreamEngine.h"
-#include <poppler/cpp/poppler-page.h>
+#include "tabula/PageSnapshot.h"
 #include <vector>
+#ifdef HAVE_POPPLER
+#include <poppler/cpp/poppler-page.h>
+#endif
 
 namespace tabula {
 
-// Engine that analyzes a poppler::page raster image to find long
-// horizontal/vertical strokes and converts them to Ruling objects.
+// Engine that analyzes the text geometry of a Poppler page to find positions
+// where many boxes align and converts them to Ruling objects.
 class ObjectExtractorPopplerEngine : public ObjectExtractorStreamEngine {
 public:
   ObjectExtractorPopplerEngine() {}
   ~ObjectExtractorPopplerEngine() {}
 
-  // analyze the poppler page and populate rulings via addSegment
-  void analyze(poppler::page &p);
+  // analyze a page snapshot and populate rulings via addSegment
+  void analyze(const PageSnapshot &snapshot);
+
+#ifdef HAVE_POPPLER
+  // convenience: snapshot the poppler page and analyze it
+  void analyze(poppler::page &p) { analyze(PageSnapshot::fromPoppler(p)); }
+#endif
 };
 
 } // namespace tabula
-#endif
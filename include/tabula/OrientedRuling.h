@@ -0,0 +1,115 @@
+#pragma once
+#include "tabula/Ruling.h"
+#include <algorithm>
+#include <vector>
+
+namespace tabula {
+
+enum class RulingOrientation { Horizontal, Vertical };
+
+// A ruling whose orientation is part of its type. Page::addRuling classifies
+// each ruling once; after that, position/start/end are plain fields and the
+// Rectangle-style getters resolve at compile time, with none of Ruling's
+// oblique checks or exceptions.
+//
+// For a horizontal ruling position is y and [start, end] spans x; for a
+// vertical one position is x and [start, end] spans y. start <= end.
+template <RulingOrientation O> struct OrientedRuling {
+  static const bool isVertical = O == RulingOrientation::Vertical;
+
+  float position = 0, start = 0, end = 0;
+
+  OrientedRuling() {}
+  OrientedRuling(float position_, float start_, float end_)
+      : position(position_), start(start_), end(end_) {}
+  // `r` must have this orientation (r.horizontal() or r.vertical()).
+  explicit OrientedRuling(const Ruling &r)
+      : position(static_cast<float>(isVertical ? r.getLeft() : r.getTop())),
+        start(static_cast<float>(isVertical ? r.getTop() : r.getLeft())),
+        end(static_cast<float>(isVertical ? r.getBottom() : r.getRight())) {}
+
+  float getPosition() const { return position; }
+  float getStart() const { return start; }
+  float getEnd() const { return end; }
+  double length() const { return static_cast<double>(end) - start; }
+
+  float getLeft() const { return isVertical ? position : start; }
+  float getRight() const { return isVertical ? position : end; }
+  float getTop() const { return isVertical ? start : position; }
+  float getBottom() const { return isVertical ? end : position; }
+
+  OrientedRuling expand(float amount) const {
+    return OrientedRuling(position, start - amount, end + amount);
+  }
+
+  Ruling toRuling() const {
+    return isVertical ? Ruling(position, start, position, end)
+                      : Ruling(start, position, end, position);
+  }
+};
+
+template <RulingOrientation O> const bool OrientedRuling<O>::isVertical;
+
+typedef OrientedRuling<RulingOrientation::Horizontal> HorizontalRuling;
+typedef OrientedRuling<RulingOrientation::Vertical> VerticalRuling;
+
+// Splits rulings by orientation; oblique ones are dropped. A ruling short
+// enough to count as both (under 0.01pt) goes to both lists, as with
+// Ruling::horizontal()/vertical().
+inline void splitRulings(const std::vector<Ruling> &rulings,
+                         std::vector<HorizontalRuling> &horizontal,
+                         std::vector<VerticalRuling> &vertical) {
+  for (const auto &r : rulings) {
+    if (r.horizontal())
+      horizontal.emplace_back(r);
+    if (r.vertical())
+      vertical.emplace_back(r);
+  }
+}
+
+template <RulingOrientation O>
+std::vector<Ruling> toRulings(const std::vector<OrientedRuling<O>> &lines) {
+  std::vector<Ruling> rv;
+  rv.reserve(lines.size());
+  for (const auto &l : lines)
+    rv.push_back(l.toRuling());
+  return rv;
+}
+
+// Collapse as in Ruling::collapseOrientedRulings: sort by position, then
+// start, and merge each ruling into the previous one when both lie on the
+// same line and their spans, each grown by expandAmount, touch. Zero-length
+// rulings that merge into nothing are dropped. The sort is strictly by
+// (position, start), without the 0.01 tolerance on position, which only
+// matters for rulings less than 0.01pt apart.
+template <RulingOrientation O>
+std::vector<OrientedRuling<O>>
+collapseRulings(std::vector<OrientedRuling<O>> lines, int expandAmount = 1) {
+  std::sort(lines.begin(), lines.end(),
+            [](const OrientedRuling<O> &a, const OrientedRuling<O> &b) {
+              return a.position < b.position ||
+                     (a.position == b.position && a.start < b.start);
+            });
+
+  std::vector<OrientedRuling<O>> rv;
+  for (const auto &next : lines) {
+    if (!rv.empty()) {
+      OrientedRuling<O> &last = rv.back();
+      // Parallel rulings have zero thickness, so their boxes only meet
+      // when they sit at exactly the same position.
+      if (last.position == next.position &&
+          last.start - expandAmount <= next.end + expandAmount &&
+          next.start - expandAmount <= last.end + expandAmount) {
+        last.start = std::min(last.start, next.start);
+        last.end = std::max(last.end, next.end);
+        continue;
+      }
+    }
+    if (next.length() == 0)
+      continue;
+    rv.push_back(next);
+  }
+  return rv;
+}
+
+} // namespace tabula
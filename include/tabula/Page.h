@@ -1,9 +1,17 @@
 #pragma once
+#include "tabula/OrientedRuling.h"
 #include "tabula/Rectangle.h"
 #include "tabula/Ruling.h"
+#include "tabula/RulingSet.h"
+#include "tabula/SpatialIndex.h"
+#include "tabula/TextArena.h"
 #include "tabula/TextChunk.h"
+#include "tabula/TextLayout.h"
 #include "tabula/Utils.h"
+#include <cstdint>
+#include <memory>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace tabula {
@@ -13,105 +21,137 @@ public:
   Page() : Rectangle(), minCharWidth(0), minCharHeight(0), pageNumber(0) {}
   explicit Page(int number)
       : Rectangle(), minCharWidth(0), minCharHeight(0), pageNumber(number) {}
-  void addTextChunk(const TextChunk &tc) { textChunks.push_back(tc); }
+  void addTextChunk(const TextChunk &tc) {
+    textChunks.push_back(tc);
+    textIndexBuilt = false;
+    textLayout.reset();
+  }
+  // The chunks' elements view the page's TextArena (see getTextArena());
+  // copies of them are valid only while the page or a copy of it is alive.
   const std::vector<TextChunk> &getTextChunks() const { return textChunks; }
 
-  const std::vector<Ruling> &getRulings() const {
-    if (!cleanRulings.empty())
-      return cleanRulings;
+  // Arena the text of this page's TextElements points into, if they were
+  // built over one (PageSnapshot::toTextElements); the page and its copies
+  // keep it alive, and it is freed in one piece with the last of them.
+  void setTextArena(std::shared_ptr<const TextArena> arena) {
+    textArena = std::move(arena);
+  }
+  const std::shared_ptr<const TextArena> &getTextArena() const {
+    return textArena;
+  }
 
-    if (rulings.empty()) {
-      verticalRulingLines.clear();
-      horizontalRulingLines.clear();
-      return cleanRulings;
-    }
+  // Spatial index over the TextElements of all text chunks, built on first
+  // use and rebuilt after chunks are added. Ids follow page order (chunk by
+  // chunk, element by element); resolve them with getTextElement().
+  const SpatialIndex<Rectangle> &getTextElementIndex() const;
+  // Views the page's TextArena, like the elements of getTextChunks().
+  const TextElement &getTextElement(size_t id) const;
+  // Copies of the TextElements overlapping `area` (overlapRatio > 0 either
+  // way), in page order. They own their text, so they outlive the page.
+  std::vector<TextElement> getTextElementsOverlapping(const Rectangle &area) const;
+  // Their ids, for use with getTextLayout().
+  std::vector<uint32_t> getTextElementIdsOverlapping(const Rectangle &area) const;
+  // The same elements (same ids) copied into a flat TextStore, with their
+  // geometry laid out for grouping; built on first use and shared by copies
+  // of the page.
+  const TextLayout &getTextLayout() const;
+  std::shared_ptr<const TextStore> getTextStore() const {
+    return getTextLayout().sharedStore();
+  }
 
-    // snap points
-    // make a mutable copy for snapping
-    std::vector<Ruling> temp = rulings;
-    Utils::snapPoints(temp, minCharWidth, minCharHeight);
+  // Snapped and collapsed rulings, computed on first use and shared by every
+  // algorithm run on this page. Adding rulings starts a new set; sets handed
+  // out earlier stay valid.
+  std::shared_ptr<const RulingSet> getRulingSet() const {
+    if (!rulingSet)
+      rulingSet = std::make_shared<const RulingSet>(rulings, minCharWidth,
+                                                    minCharHeight);
+    return rulingSet;
+  }
 
-    // separate vertical/horizontal
-    verticalRulingLines = getCollapsedVerticalRulings(temp);
-    horizontalRulingLines = getCollapsedHorizontalRulings(temp);
+  const std::vector<Ruling> &getRulings() const {
+    return getRulingSet()->getRulings();
+  }
+  const std::vector<HorizontalRuling> &getHorizontalRulings() const {
+    return getRulingSet()->getHorizontalRulings();
+  }
+  const std::vector<VerticalRuling> &getVerticalRulings() const {
+    return getRulingSet()->getVerticalRulings();
+  }
 
-    cleanRulings = verticalRulingLines;
-    cleanRulings.insert(cleanRulings.end(), horizontalRulingLines.begin(),
-                        horizontalRulingLines.end());
-    return cleanRulings;
+  void addRuling(const Ruling &r) {
+    if (acceptRuling(r))
+      rulingSet.reset();
   }
 
-  std::vector<Ruling>
-  getCollapsedVerticalRulings(const std::vector<Ruling> &source) const {
-    std::vector<Ruling> verticalRulings;
-    for (const auto &r : source)
-      if (r.vertical())
-        verticalRulings.push_back(r);
-    return Ruling::collapseOrientedRulings(verticalRulings);
+  // Adds several rulings with a single cache invalidation.
+  void addRulings(const std::vector<Ruling> &rs) {
+    rulings.reserve(rulings.size() + rs.size());
+    bool added = false;
+    for (const auto &r : rs)
+      added = acceptRuling(r) || added;
+    if (added)
+      rulingSet.reset();
   }
 
-  std::vector<Ruling>
-  getCollapsedHorizontalRulings(const std::vector<Ruling> &source) const {
-    std::vector<Ruling> horizontalRulings;
-    for (const auto &r : source)
-      if (r.horizontal())
-        horizontalRulings.push_back(r);
-    return Ruling::collapseOrientedRulings(horizontalRulings);
+  const std::vector<Ruling> &getUnprocessedRulings() const { return rulings; }
+
+  void setMinCharDims(float w, float h) {
+    minCharWidth = w;
+    minCharHeight = h;
+    rulingSet.reset(); // snapping thresholds changed
   }
 
-  void addRuling(const Ruling &r) {
-    // Normalize a copy of the incoming ruling and accept it if it becomes
-    // vertical/horizontal.
+  // Convenience: run projection-profile separators using this page's text
+  // elements
+  std::vector<float> findVerticalSeparators(float minColumnWidth) const;
+  std::vector<float> findHorizontalSeparators(float minRowHeight) const;
+
+  void setPageNumber(int n) { pageNumber = n; }
+  int getPageNumber() const { return pageNumber; }
+
+private:
+  // Normalizes a copy of `r` and stores it if it ends up vertical or
+  // horizontal; returns false when the ruling was dropped.
+  bool acceptRuling(const Ruling &r) {
     Ruling nr = r;
     // Ignore zero-length rulings
     if (nr.length() == 0)
-      return;
+      return false;
     nr.normalize();
     if (nr.oblique()) {
       // Try a wider tolerance: if angle is within 5 degrees of axis, force it
       try {
         double angle = nr.getAngle();
         if (Utils::within(angle, 0, 5) || Utils::within(angle, 180, 5)) {
-          nr.y2 = nr.y1; // force horizontal
+          nr.setLine(nr.getX1(), nr.getY1(), nr.getX2(),
+                     nr.getY1()); // force horizontal
         } else if (Utils::within(angle, 90, 5) ||
                    Utils::within(angle, 270, 5)) {
-          nr.x2 = nr.x1; // force vertical
+          nr.setLine(nr.getX1(), nr.getY1(), nr.getX1(),
+                     nr.getY2()); // force vertical
         } else {
           // As a last resort, skip the oblique ruling silently
-          return;
+          return false;
         }
       } catch (...) {
         // If angle can't be determined, skip the ruling
-        return;
+        return false;
       }
     }
     rulings.push_back(nr);
-    verticalRulingLines.clear();
-    horizontalRulingLines.clear();
-    cleanRulings.clear();
+    return true;
   }
 
-  const std::vector<Ruling> &getUnprocessedRulings() const { return rulings; }
-
-  void setMinCharDims(float w, float h) {
-    minCharWidth = w;
-    minCharHeight = h;
-  }
-
-  // Convenience: run projection-profile separators using this page's text
-  // elements
-  std::vector<float> findVerticalSeparators(float minColumnWidth) const;
-  std::vector<float> findHorizontalSeparators(float minRowHeight) const;
-
-  void setPageNumber(int n) { pageNumber = n; }
-  int getPageNumber() const { return pageNumber; }
-
-private:
   std::vector<TextChunk> textChunks;
+  std::shared_ptr<const TextArena> textArena;
   std::vector<Ruling> rulings;
-  mutable std::vector<Ruling> cleanRulings;
-  mutable std::vector<Ruling> verticalRulingLines;
-  mutable std::vector<Ruling> horizontalRulingLines;
+  mutable std::shared_ptr<const RulingSet> rulingSet;
+  // (chunk, element) position of each indexed TextElement, by id
+  mutable std::vector<std::pair<uint32_t, uint32_t>> textElementPositions;
+  mutable SpatialIndex<Rectangle> textIndex;
+  mutable std::shared_ptr<const TextLayout> textLayout;
+  mutable bool textIndexBuilt = false;
   float minCharWidth;
   float minCharHeight;
   int pageNumber;
@@ -0,0 +1,24 @@
+#pragma once
+#include "tabula/Table.h"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace tabula {
+
+// Extracts a page's tables; `k` is the position in the list of pages to run.
+using PageExtractor = std::function<std::vector<Table>(size_t k)>;
+
+// Runs pages [0, n) on `threads` workers. `makeWorker` is called once on
+// each worker thread and returns the extractor that worker uses, so each
+// worker can hold objects it must not share (poppler-cpp documents, say).
+// Workers pull pages from a shared counter; finished pages are handed to
+// `emit` on the calling thread strictly in order, and workers never run
+// more than 4 pages per thread ahead of the last emitted one, which bounds
+// the number of pages in memory. The first exception thrown by a worker or
+// by `emit` stops the run and is rethrown once the workers have joined.
+void extractInPageOrder(size_t n, int threads,
+                        const std::function<PageExtractor()> &makeWorker,
+                        const std::function<void(std::vector<Table> &)> &emit);
+
+} // namespace tabula
@@ -0,0 +1,42 @@
+#pragma once
+#include "tabula/TextArena.h"
+#include "tabula/TextElement.h"
+#include <string>
+#include <vector>
+#ifdef HAVE_POPPLER
+#include <poppler/cpp/poppler-page.h>
+#endif
+
+namespace tabula {
+
+// Text geometry of one page, captured from a single
+// poppler::page::text_list() call. Boxes are already flipped from Poppler's
+// bottom-left origin to the top-left origin used by Page, so the TextElement
+// builder and the ruling engine share one snapshot instead of each asking
+// Poppler to lay out the page text again.
+struct PageSnapshot {
+  struct TextBox {
+    float top;
+    float left;
+    float width;
+    float height;
+    std::string text; // UTF-8
+  };
+
+  float width = 0.0f;
+  float height = 0.0f;
+  std::vector<TextBox> boxes;
+
+  // One TextElement per box; width-of-space is approximated as 0.25 * box
+  // height since Poppler doesn't expose it easily.
+  std::vector<TextElement> toTextElements() const;
+  // The same, with the text copied into `arena` (one allocation per block
+  // rather than per box); the elements are valid while the arena lives.
+  std::vector<TextElement> toTextElements(TextArena &arena) const;
+
+#ifdef HAVE_POPPLER
+  static PageSnapshot fromPoppler(poppler::page &p);
+#endif
+};
+
+} // namespace tabula
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tabula {
+
+// Read-only view of a PDF's bytes. Files are memory-mapped where the
+// platform supports it, stdin is read once into an owned buffer, and caller
+// memory is borrowed as-is, so documents can be handed to
+// poppler::document::load_from_raw_data without temp files or extra copies.
+// The bytes must outlive every document opened over them.
+class PdfSource {
+public:
+  ~PdfSource();
+  PdfSource(const PdfSource &) = delete;
+  PdfSource &operator=(const PdfSource &) = delete;
+
+  // Map (or, without mmap support, read) a file. Returns nullptr on failure.
+  static std::unique_ptr<PdfSource> fromFile(const std::string &path);
+  // Read a whole stream, e.g. std::cin. Returns nullptr on read errors.
+  static std::unique_ptr<PdfSource> fromStream(std::istream &in);
+  // Borrow caller-owned memory; nothing is copied.
+  static std::unique_ptr<PdfSource> fromBuffer(const char *data, size_t size);
+  // "-" means stdin, anything else is a file path.
+  static std::unique_ptr<PdfSource> open(const std::string &path);
+
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+private:
+  PdfSource() : data_(nullptr), size_(0), mapped_(false) {}
+
+  const char *data_;
+  size_t size_;
+  bool mapped_;
+  std::vector<char> owned_;
+};
+
+} // namespace tabula
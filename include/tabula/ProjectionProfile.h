@@ -1,5 +1,6 @@
 #pragma once
 #include "tabula/Rectangle.h"
+#include "tabula/RulingIndex.h"
 #include "tabula/Ruling.h"
 #include <algorithm>
 #include <limits>
@@ -42,6 +43,12 @@ public:
   std::vector<float>
   findHorizontalSeparators(float minRowHeight,
                            const std::vector<Ruling> &explicitRulings) const;
+  std::vector<float>
+  findVerticalSeparators(float minColumnWidth,
+                         const VerticalRulingIndex &explicitRulings) const;
+  std::vector<float>
+  findHorizontalSeparators(float minRowHeight,
+                           const HorizontalRulingIndex &explicitRulings) const;
 
 private:
   Rectangle area_;
@@ -59,6 +66,9 @@ private:
     return value / std::pow(10, DECIMAL_PLACES);
   }
   void addRectangle(const Rectangle &element);
+  std::vector<float> mergeSeparators(std::vector<int> separators,
+                                     const std::vector<int> &found,
+                                     float minGap, double offset) const;
 };
 
 } // namespace tabula
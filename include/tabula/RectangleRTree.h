@@ -0,0 +1,295 @@
+#pragma once
+#include "tabula/Rectangle.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace tabula {
+
+// Static R-tree for rectangle-like objects (T must expose Rectangle-like
+// getters), with the same interface as RectangleSpatialIndex.
+//
+// The tree is bulk-loaded with Sort-Tile-Recursive packing on the first query
+// after an insert: leaves hold up to `nodeCapacity` objects, every level is
+// packed the same way, and all nodes live in one contiguous array (leaves
+// first, root last) with each node's children stored contiguously. Unlike the
+// grid, a large rectangle is stored once however much of the page it covers.
+// Because of the lazy build, a single tree must not be queried from several
+// threads at once.
+template <typename T> class RectangleRTree {
+public:
+  static const size_t npos = static_cast<size_t>(-1);
+
+  // cellSize is accepted for interface compatibility with
+  // RectangleSpatialIndex and ignored.
+  explicit RectangleRTree(float cellSize = 0.0f) { (void)cellSize; }
+
+  void add(const T &obj) {
+    boxes.push_back(boxOf(obj));
+    rects.push_back(obj);
+    built = false;
+  }
+
+  void add(T &&obj) {
+    boxes.push_back(boxOf(obj));
+    rects.push_back(std::move(obj));
+    built = false;
+  }
+
+  // alias for compatibility
+  void insert(const T &obj) { add(obj); }
+
+  size_t size() const { return rects.size(); }
+  bool empty() const { return rects.empty(); }
+  // object by id (ids are insertion indices)
+  const T &get(size_t id) const { return rects[id]; }
+
+  // Calls visit(id) once for every object overlapping `area` (touching edges
+  // count), in no particular order.
+  template <typename F> void forEachId(Rectangle const &area, F visit) const {
+    ensureBuilt();
+    if (nodes.empty())
+      return;
+    const Box q{area.getLeft(), area.getTop(), area.getRight(),
+                area.getBottom()};
+    std::vector<uint32_t> stack;
+    stack.push_back(static_cast<uint32_t>(nodes.size() - 1));
+    while (!stack.empty()) {
+      const Node &n = nodes[stack.back()];
+      stack.pop_back();
+      if (!n.box.overlaps(q))
+        continue;
+      if (n.leaf) {
+        for (uint32_t k = n.first; k < n.first + n.count; ++k)
+          if (boxes[order[k]].overlaps(q))
+            visit(static_cast<size_t>(order[k]));
+      } else {
+        for (uint32_t c = n.first; c < n.first + n.count; ++c)
+          stack.push_back(c);
+      }
+    }
+  }
+
+  // Calls visit(const T&) for every object overlapping `area`; nothing is
+  // copied.
+  template <typename F> void forEach(Rectangle const &area, F visit) const {
+    forEachId(area, [&](size_t id) { visit(rects[id]); });
+  }
+
+  // ids of objects that overlap the query area
+  std::vector<size_t> queryIds(Rectangle const &area) const {
+    std::vector<size_t> out;
+    forEachId(area, [&](size_t id) { out.push_back(id); });
+    return out;
+  }
+
+  // ids of objects fully contained inside 'area'
+  std::vector<size_t> containsIds(Rectangle const &area) const {
+    std::vector<size_t> out;
+    forEachId(area, [&](size_t id) {
+      if (area.contains(rects[id]))
+        out.push_back(id);
+    });
+    return out;
+  }
+
+  // returns copies of the objects that overlap the query area
+  std::vector<T> query(Rectangle const &area) const {
+    std::vector<T> out;
+    forEach(area, [&](const T &r) { out.push_back(r); });
+    return out;
+  }
+
+  // returns copies of the objects fully contained inside 'area'
+  std::vector<T> contains(Rectangle const &area) const {
+    std::vector<T> out;
+    forEach(area, [&](const T &r) {
+      if (area.contains(r))
+        out.push_back(r);
+    });
+    return out;
+  }
+
+  std::vector<T> intersects(Rectangle const &area) const { return query(area); }
+
+  // id of the object closest to (x, y) (distance 0 when the point lies
+  // inside it), or npos when the tree is empty. Ties go to the lower id.
+  size_t nearestId(float x, float y) const {
+    ensureBuilt();
+    if (nodes.empty())
+      return npos;
+    // Best-first search: entries are (squared distance, node or ~object id).
+    typedef std::pair<float, uint64_t> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    const uint64_t objectBit = uint64_t(1) << 63;
+    heap.push(Entry(nodes.back().box.distance2(x, y), nodes.size() - 1));
+    while (!heap.empty()) {
+      Entry e = heap.top();
+      heap.pop();
+      if (e.second & objectBit)
+        return static_cast<size_t>(e.second & ~objectBit);
+      const Node &n = nodes[static_cast<size_t>(e.second)];
+      if (n.leaf) {
+        for (uint32_t k = n.first; k < n.first + n.count; ++k)
+          heap.push(Entry(boxes[order[k]].distance2(x, y),
+                          objectBit | order[k]));
+      } else {
+        for (uint32_t c = n.first; c < n.first + n.count; ++c)
+          heap.push(Entry(nodes[c].box.distance2(x, y), c));
+      }
+    }
+    return npos;
+  }
+
+  Rectangle getBounds() const {
+    if (rects.empty())
+      return Rectangle();
+    ensureBuilt();
+    const Box &b = nodes.back().box;
+    return Rectangle(b.top, b.left, b.right - b.left, b.bottom - b.top);
+  }
+
+  void clear() {
+    rects.clear();
+    boxes.clear();
+    built = false;
+  }
+
+  // maximum number of entries per node
+  static const uint32_t nodeCapacity = 16;
+
+private:
+  struct Box {
+    float left, top, right, bottom;
+    bool overlaps(const Box &q) const {
+      return !(right < q.left || left > q.right || bottom < q.top ||
+               top > q.bottom);
+    }
+    float distance2(float x, float y) const {
+      float dx = std::max(std::max(left - x, x - right), 0.0f);
+      float dy = std::max(std::max(top - y, y - bottom), 0.0f);
+      return dx * dx + dy * dy;
+    }
+    void expand(const Box &o) {
+      left = std::min(left, o.left);
+      top = std::min(top, o.top);
+      right = std::max(right, o.right);
+      bottom = std::max(bottom, o.bottom);
+    }
+    float centerX() const { return (left + right) * 0.5f; }
+    float centerY() const { return (top + bottom) * 0.5f; }
+  };
+
+  struct Node {
+    Box box;
+    uint32_t first; // first child node, or first slot in `order` for leaves
+    uint32_t count;
+    bool leaf;
+  };
+
+  std::vector<T> rects;
+  std::vector<Box> boxes;
+
+  mutable bool built = false;
+  mutable std::vector<Node> nodes;
+  // object ids in leaf order
+  mutable std::vector<uint32_t> order;
+
+  static Box boxOf(const T &t) {
+    return Box{std::min(t.getLeft(), t.getRight()),
+               std::min(t.getTop(), t.getBottom()),
+               std::max(t.getLeft(), t.getRight()),
+               std::max(t.getTop(), t.getBottom())};
+  }
+
+  void ensureBuilt() const {
+    if (!built)
+      build();
+  }
+
+  // Sort-Tile-Recursive: sort entries by center x, cut them into
+  // ceil(sqrt(P)) vertical slices (P = number of nodes to create), sort each
+  // slice by center y and pack runs of nodeCapacity entries into nodes.
+  // `entries` is reordered in place; returns the node boxes' [first, count)
+  // runs over it.
+  static std::vector<std::pair<uint32_t, uint32_t>>
+  strPack(std::vector<uint32_t> &entries, const std::vector<Box> &entryBoxes) {
+    const size_t n = entries.size();
+    const size_t pages = (n + nodeCapacity - 1) / nodeCapacity;
+    const size_t slices =
+        static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(pages))));
+    const size_t sliceSize = slices * nodeCapacity;
+    std::sort(entries.begin(), entries.end(), [&](uint32_t a, uint32_t b) {
+      return entryBoxes[a].centerX() < entryBoxes[b].centerX();
+    });
+    std::vector<std::pair<uint32_t, uint32_t>> runs;
+    runs.reserve(pages);
+    for (size_t s = 0; s < n; s += sliceSize) {
+      const size_t e = std::min(n, s + sliceSize);
+      std::sort(entries.begin() + s, entries.begin() + e,
+                [&](uint32_t a, uint32_t b) {
+                  return entryBoxes[a].centerY() < entryBoxes[b].centerY();
+                });
+      for (size_t k = s; k < e; k += nodeCapacity)
+        runs.push_back(std::make_pair(
+            static_cast<uint32_t>(k),
+            static_cast<uint32_t>(std::min<size_t>(nodeCapacity, e - k))));
+    }
+    return runs;
+  }
+
+  void build() const {
+    built = true;
+    nodes.clear();
+    order.clear();
+    if (boxes.empty())
+      return;
+
+    // leaves over the objects
+    order.resize(boxes.size());
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = static_cast<uint32_t>(i);
+    for (const auto &run : strPack(order, boxes)) {
+      Node leaf{boxes[order[run.first]], run.first, run.second, true};
+      for (uint32_t k = run.first; k < run.first + run.second; ++k)
+        leaf.box.expand(boxes[order[k]]);
+      nodes.push_back(leaf);
+    }
+
+    // upper levels: pack the previous level's nodes until one root is left
+    size_t levelBegin = 0;
+    while (nodes.size() - levelBegin > 1) {
+      const size_t levelEnd = nodes.size();
+      std::vector<Box> levelBoxes;
+      std::vector<uint32_t> entries;
+      for (size_t i = levelBegin; i < levelEnd; ++i) {
+        levelBoxes.push_back(nodes[i].box);
+        entries.push_back(static_cast<uint32_t>(i - levelBegin));
+      }
+      auto runs = strPack(entries, levelBoxes);
+      // children must be contiguous: reorder this level to packing order
+      std::vector<Node> level;
+      level.reserve(entries.size());
+      for (uint32_t e : entries)
+        level.push_back(nodes[levelBegin + e]);
+      std::copy(level.begin(), level.end(), nodes.begin() + levelBegin);
+      for (const auto &run : runs) {
+        uint32_t first = static_cast<uint32_t>(levelBegin + run.first);
+        Node parent{nodes[first].box, first, run.second, false};
+        for (uint32_t c = first; c < first + run.second; ++c)
+          parent.box.expand(nodes[c].box);
+        nodes.push_back(parent);
+      }
+      levelBegin = levelEnd;
+    }
+  }
+};
+
+template <typename T> const size_t RectangleRTree<T>::npos;
+template <typename T> const uint32_t RectangleRTree<T>::nodeCapacity;
+
+} // namespace tabula
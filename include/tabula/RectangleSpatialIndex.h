@@ -1,73 +1,120 @@
 #pragma once
 #include "tabula/Rectangle.h"
+#include <algorithm>
 #include <cmath>
 #include <limits>
-#include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace tabula {
 
 // Template spatial index for rectangle-like objects (T must expose
-// Rectangle-like getters)
+// Rectangle-like getters).
+//
+// Objects are stored by value in insertion order; the grid is built lazily
+// on the first query after an insert. The grid is a dense nx * ny array of
+// cells covering the bounds of all objects, with each cell's object ids kept
+// contiguously (CSR layout: `offsets` into one `ids` array). Objects spanning
+// several cells are reported once per query using a per-object query stamp.
+// Because of the lazy build and the stamps, a single index must not be
+// queried from several threads at once.
 template <typename T> class RectangleSpatialIndex {
 public:
-  explicit RectangleSpatialIndex(float cellSize_ = 50.0f)
+  // cellSize <= 0 derives the cell size from the bounds and density of the
+  // indexed objects when the grid is built.
+  explicit RectangleSpatialIndex(float cellSize_ = 0.0f)
       : cellSize(cellSize_) {}
 
   void add(const T &obj) {
-    size_t id = rects.size();
+    boxes.push_back(boxOf(obj));
     rects.push_back(obj);
-    int minX, minY, maxX, maxY;
-    std::tie(minX, minY, maxX, maxY) = cellRangeForObj(obj);
-    for (int ix = minX; ix <= maxX; ++ix) {
-      for (int iy = minY; iy <= maxY; ++iy) {
-        grid[cellKey(ix, iy)].push_back(id);
-      }
-    }
+    built = false;
+  }
+
+  void add(T &&obj) {
+    boxes.push_back(boxOf(obj));
+    rects.push_back(std::move(obj));
+    built = false;
   }
 
   // alias for compatibility
   void insert(const T &obj) { add(obj); }
 
-  // returns objects that overlap the query area
-  std::vector<T> query(Rectangle const &area) const {
-    std::vector<T> out;
+  size_t size() const { return rects.size(); }
+  bool empty() const { return rects.empty(); }
+  // object by id (ids are insertion indices)
+  const T &get(size_t id) const { return rects[id]; }
+
+  // Calls visit(id) once for every object overlapping `area` (touching edges
+  // count), in no particular order.
+  template <typename F> void forEachId(Rectangle const &area, F visit) const {
+    ensureBuilt();
     if (rects.empty())
-      return out;
-    int minX, minY, maxX, maxY;
-    std::tie(minX, minY, maxX, maxY) = cellRangeFor(area);
-    std::unordered_set<size_t> seen;
-    for (int ix = minX; ix <= maxX; ++ix) {
-      for (int iy = minY; iy <= maxY; ++iy) {
-        auto it = grid.find(cellKey(ix, iy));
-        if (it == grid.end())
-          continue;
-        for (size_t id : it->second) {
-          if (seen.insert(id).second) {
-            const T &r = rects[id];
-            if (!(r.getRight() < area.getLeft() ||
-                  r.getLeft() > area.getRight() ||
-                  r.getBottom() < area.getTop() ||
-                  r.getTop() > area.getBottom())) {
-              out.push_back(r);
-            }
+      return;
+    const float ql = area.getLeft(), qt = area.getTop();
+    const float qr = area.getRight(), qb = area.getBottom();
+    if (qr < minX || ql > maxX || qb < minY || qt > maxY)
+      return;
+    const int x0 = column(ql), x1 = column(qr);
+    const int y0 = row(qt), y1 = row(qb);
+    // A single-cell query cannot see an object twice.
+    const bool dedup = x0 != x1 || y0 != y1;
+    const unsigned stamp = dedup ? nextStamp() : 0;
+    for (int iy = y0; iy <= y1; ++iy) {
+      for (int ix = x0; ix <= x1; ++ix) {
+        const size_t cell = static_cast<size_t>(iy) * nx + ix;
+        for (size_t k = offsets[cell]; k < offsets[cell + 1]; ++k) {
+          const size_t id = ids[k];
+          if (dedup) {
+            if (stamps[id] == stamp)
+              continue;
+            stamps[id] = stamp;
           }
+          const Box &b = boxes[id];
+          if (!(b.right < ql || b.left > qr || b.bottom < qt || b.top > qb))
+            visit(id);
         }
       }
     }
+  }
+
+  // Calls visit(const T&) for every object overlapping `area`; nothing is
+  // copied.
+  template <typename F> void forEach(Rectangle const &area, F visit) const {
+    forEachId(area, [&](size_t id) { visit(rects[id]); });
+  }
+
+  // ids of objects that overlap the query area
+  std::vector<size_t> queryIds(Rectangle const &area) const {
+    std::vector<size_t> out;
+    forEachId(area, [&](size_t id) { out.push_back(id); });
+    return out;
+  }
+
+  // ids of objects fully contained inside 'area'
+  std::vector<size_t> containsIds(Rectangle const &area) const {
+    std::vector<size_t> out;
+    forEachId(area, [&](size_t id) {
+      if (area.contains(rects[id]))
+        out.push_back(id);
+    });
     return out;
   }
 
-  // returns objects fully contained inside 'area'
+  // returns copies of the objects that overlap the query area
+  std::vector<T> query(Rectangle const &area) const {
+    std::vector<T> out;
+    forEach(area, [&](const T &r) { out.push_back(r); });
+    return out;
+  }
+
+  // returns copies of the objects fully contained inside 'area'
   std::vector<T> contains(Rectangle const &area) const {
-    std::vector<T> candidates = query(area);
     std::vector<T> out;
-    for (auto const &c : candidates) {
-      if (area.contains(c))
-        out.push_back(c);
-    }
+    forEach(area, [&](const T &r) {
+      if (area.contains(r))
+        out.push_back(r);
+    });
     return out;
   }
 
@@ -76,39 +123,132 @@ public:
   Rectangle getBounds() const {
     if (rects.empty())
       return Rectangle();
-    std::vector<Rectangle> tmp;
-    tmp.reserve(rects.size());
-    for (auto const &r : rects)
-      tmp.emplace_back(r.getTop(), r.getLeft(), r.getWidth(), r.getHeight());
-    return Rectangle::boundingBoxOf(tmp);
+    ensureBuilt();
+    return Rectangle(minY, minX, maxX - minX, maxY - minY);
   }
 
   void clear() {
     rects.clear();
-    grid.clear();
+    boxes.clear();
+    built = false;
   }
 
 private:
+  struct Box {
+    float left, top, right, bottom;
+  };
+
   float cellSize;
   std::vector<T> rects;
-  std::unordered_map<long long, std::vector<size_t>> grid;
+  std::vector<Box> boxes;
 
-  static inline long long cellKey(int x, int y) {
-    return (static_cast<long long>(x) << 32) ^ static_cast<unsigned int>(y);
+  // Grid state, rebuilt lazily after inserts.
+  mutable bool built = false;
+  mutable float minX = 0, minY = 0, maxX = 0, maxY = 0;
+  mutable float cell = 1.0f;
+  mutable int nx = 0, ny = 0;
+  mutable std::vector<size_t> offsets;
+  mutable std::vector<size_t> ids;
+  mutable std::vector<unsigned> stamps;
+  mutable unsigned stamp = 0;
+
+  static Box boxOf(const T &t) {
+    return Box{std::min(t.getLeft(), t.getRight()),
+               std::min(t.getTop(), t.getBottom()),
+               std::max(t.getLeft(), t.getRight()),
+               std::max(t.getTop(), t.getBottom())};
+  }
+
+  static int cellIndex(float v, float origin, float size, int count) {
+    float d = (v - origin) / size;
+    if (!(d > 0.0f)) // also catches NaN
+      return 0;
+    if (d >= static_cast<float>(count))
+      return count - 1;
+    return static_cast<int>(d);
+  }
+  int column(float x) const { return cellIndex(x, minX, cell, nx); }
+  int row(float y) const { return cellIndex(y, minY, cell, ny); }
+
+  unsigned nextStamp() const {
+    if (++stamp == 0) {
+      std::fill(stamps.begin(), stamps.end(), 0u);
+      stamp = 1;
+    }
+    return stamp;
   }
 
-  std::tuple<int, int, int, int> cellRangeFor(const Rectangle &r) const {
-    int minX = static_cast<int>(std::floor(r.getLeft() / cellSize));
-    int maxX = static_cast<int>(std::floor(r.getRight() / cellSize));
-    int minY = static_cast<int>(std::floor(r.getTop() / cellSize));
-    int maxY = static_cast<int>(std::floor(r.getBottom() / cellSize));
-    return {minX, minY, maxX, maxY};
+  void ensureBuilt() const {
+    if (!built)
+      build();
   }
 
-  // overload to accept T
-  std::tuple<int, int, int, int> cellRangeForObj(const T &t) const {
-    return cellRangeFor(
-        Rectangle(t.getTop(), t.getLeft(), t.getWidth(), t.getHeight()));
+  void build() const {
+    built = true;
+    const size_t n = boxes.size();
+    stamps.assign(n, 0u);
+    stamp = 0;
+    if (n == 0) {
+      nx = ny = 0;
+      offsets.assign(1, 0);
+      ids.clear();
+      return;
+    }
+
+    minX = minY = std::numeric_limits<float>::max();
+    maxX = maxY = std::numeric_limits<float>::lowest();
+    double sumW = 0, sumH = 0;
+    for (const Box &b : boxes) {
+      minX = std::min(minX, b.left);
+      minY = std::min(minY, b.top);
+      maxX = std::max(maxX, b.right);
+      maxY = std::max(maxY, b.bottom);
+      sumW += b.right - b.left;
+      sumH += b.bottom - b.top;
+    }
+    const float w = std::max(maxX - minX, 1e-3f);
+    const float h = std::max(maxY - minY, 1e-3f);
+
+    // Adaptive size: about one object per cell, but no smaller than the
+    // average object so an object typically touches at most four cells.
+    float size = cellSize;
+    if (!(size > 0.0f)) {
+      size = static_cast<float>(std::sqrt(static_cast<double>(w) * h / n));
+      size = std::max(size, static_cast<float>(std::max(sumW, sumH) / n));
+    }
+    if (!(size > 0.0f) || !std::isfinite(size))
+      size = std::max(w, h);
+    // Bound the grid to O(n) cells however small the requested size is.
+    const double maxCells = std::max<double>(64.0, 4.0 * n);
+    double cells = (std::floor(w / size) + 1.0) * (std::floor(h / size) + 1.0);
+    if (cells > maxCells)
+      size *= static_cast<float>(std::sqrt(cells / maxCells)) * 1.01f;
+    cell = size;
+    nx = static_cast<int>(std::min<double>(std::floor(w / size) + 1.0, maxCells));
+    ny = static_cast<int>(std::min<double>(std::floor(h / size) + 1.0, maxCells));
+
+    // Count, prefix-sum, then fill: ids of each cell end up contiguous and in
+    // insertion order.
+    offsets.assign(static_cast<size_t>(nx) * ny + 1, 0);
+    for (const Box &b : boxes) {
+      const int x0 = column(b.left), x1 = column(b.right);
+      const int y0 = row(b.top), y1 = row(b.bottom);
+      for (int iy = y0; iy <= y1; ++iy)
+        for (int ix = x0; ix <= x1; ++ix)
+          ++offsets[static_cast<size_t>(iy) * nx + ix + 1];
+    }
+    for (size_t c = 1; c < offsets.size(); ++c)
+      offsets[c] += offsets[c - 1];
+    ids.resize(offsets.back());
+    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t id = 0; id < n; ++id) {
+      const Box &b = boxes[id];
+      const int x0 = column(b.left), x1 = column(b.right);
+      const int y0 = row(b.top), y1 = row(b.bottom);
+      for (int iy = y0; iy <= y1; ++iy)
+        for (int ix = x0; ix <= x1; ++ix)
+          ids[cursor[static_cast<size_t>(iy) * nx + ix]++] = id;
+    }
   }
 };
 
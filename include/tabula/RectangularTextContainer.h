@@ -2,6 +2,8 @@
 #include "tabula/HasText.h"
 #include "tabula/Rectangle.h"
 #include "tabula/TextElement.h"
+#include <algorithm>
+#include <string>
 #include <vector>
 
 namespace tabula {
@@ -13,46 +15,41 @@ public:
       : Rectangle(top, left, width, height) {}
   RectangularTextContainer() : Rectangle() {}
 
-  RectangularTextContainer<T> &merge(const RectangularTextContainer<T> &other) {
+  // The element accessors and the container merges are virtual: a subclass
+  // keeping its elements elsewhere (Cell's TextStore range) must be read and
+  // changed through its own versions, also via a base reference.
+  virtual RectangularTextContainer<T> &
+  merge(const RectangularTextContainer<T> &other) {
     // append other's elements (no ordering semantics here)
     // Note: in Java this also merges geometry
-    for (auto &e : other.textElements)
-      textElements.push_back(e);
+    const std::vector<T> &elements = other.getTextElements();
+    textElements.insert(textElements.end(), elements.begin(), elements.end());
     Rectangle::merge(other);
     return *this;
   }
 
-  const std::vector<T> &getTextElements() const { return textElements; }
-  std::vector<T> &getTextElements() { return textElements; }
-  void setTextElements(const std::vector<T> &v) { textElements = v; }
+  virtual const std::vector<T> &getTextElements() const { return textElements; }
+  virtual std::vector<T> &getTextElements() { return textElements; }
+  virtual void setTextElements(const std::vector<T> &v) { textElements = v; }
 
   // getText() implementations provided below
 
   // Generic implementation that assumes T has getText(), getTop(), getLeft()
   std::string getText(bool useLineReturns) const override {
-    if (textElements.empty())
-      return std::string();
-    // make a local copy and sort like Java: by top then left
-    auto copy = textElements;
-    std::sort(copy.begin(), copy.end(), [](const T &a, const T &b) {
-      if (a.getTop() != b.getTop())
-        return a.getTop() < b.getTop();
-      return a.getLeft() < b.getLeft();
-    });
     std::string out;
-    float curTop = copy.front().getTop();
-    for (auto const &tc : copy) {
-      if (useLineReturns && tc.getTop() > curTop)
+    if (textElements.empty())
+      return out;
+    // sort like Java: by top then left
+    std::vector<const T *> order = sortedElements();
+    float curTop = order.front()->getTop();
+    for (const T *tc : order) {
+      if (useLineReturns && tc->getTop() > curTop)
         out.push_back('\r');
-      out += tc.getText();
-      curTop = tc.getTop();
+      out += tc->getText();
+      curTop = tc->getTop();
     }
-    // trim whitespace
-    auto lpos = out.find_first_not_of(" \t\n\r");
-    if (lpos == std::string::npos)
-      return std::string();
-    auto rpos = out.find_last_not_of(" \t\n\r");
-    return out.substr(lpos, rpos - lpos + 1);
+    trimText(out);
+    return out;
   }
 
   std::string getText() const override { return getText(true); }
@@ -61,14 +58,38 @@ public:
   void merge(const T &elem) { Rectangle::merge(elem); }
 
   // helper to merge a container at index with another
-  void mergeInPlace(const RectangularTextContainer<T> &other) {
-    for (auto &e : other.textElements)
-      textElements.push_back(e);
-    Rectangle::merge(other);
+  virtual void mergeInPlace(const RectangularTextContainer<T> &other) {
+    merge(other);
   }
 
 protected:
   std::vector<T> textElements;
+
+  // The elements in reading order (top, then left). Sorting pointers
+  // gives the same order as sorting copies of the elements.
+  std::vector<const T *> sortedElements() const {
+    std::vector<const T *> order;
+    order.reserve(textElements.size());
+    for (const auto &e : textElements)
+      order.push_back(&e);
+    std::sort(order.begin(), order.end(), [](const T *a, const T *b) {
+      if (a->getTop() != b->getTop())
+        return a->getTop() < b->getTop();
+      return a->getLeft() < b->getLeft();
+    });
+    return order;
+  }
+
+  // Strips whitespace from both ends in place.
+  static void trimText(std::string &s) {
+    const size_t rpos = s.find_last_not_of(" \t\n\r");
+    if (rpos == std::string::npos) {
+      s.clear();
+      return;
+    }
+    s.erase(rpos + 1);
+    s.erase(0, s.find_first_not_of(" \t\n\r"));
+  }
 };
 
 } // namespace tabula
@@ -1,17 +1,25 @@
 #pragma once
-#include "Line.h"
 #include "tabula/Rectangle.h"
 #include "tabula/Utils.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace tabula {
 
-struct Ruling : public Line {
+// A ruling line: two float endpoints plus orientation flags, computed once
+// whenever the endpoints change. Rulings are copied freely (expand(),
+// collapsing, cropping), so the type is kept trivially copyable and does not
+// derive from Line, which carries text storage.
+struct Ruling {
+  Ruling() {}
   Ruling(double x1_, double y1_, double x2_, double y2_)
-      : Line(x1_, y1_, x2_, y2_) {
+      : x1(static_cast<float>(x1_)), y1(static_cast<float>(y1_)),
+        x2(static_cast<float>(x2_)), y2(static_cast<float>(y2_)) {
     normalize();
   }
 
@@ -24,14 +32,33 @@ struct Ruling : public Line {
       // almost vertical: set both x to x1
       x2 = x1;
     }
+    classify();
   }
 
-  bool vertical() const { return length() > 0 && Utils::feq(x1, x2); }
-  bool horizontal() const { return length() > 0 && Utils::feq(y1, y2); }
-  bool oblique() const { return !(vertical() || horizontal()); }
+  double getX1() const { return x1; }
+  double getY1() const { return y1; }
+  double getX2() const { return x2; }
+  double getY2() const { return y2; }
+
+  // Replaces both endpoints as given (no normalization).
+  void setLine(double x1_, double y1_, double x2_, double y2_) {
+    x1 = static_cast<float>(x1_);
+    y1 = static_cast<float>(y1_);
+    x2 = static_cast<float>(x2_);
+    y2 = static_cast<float>(y2_);
+    classify();
+  }
+
+  double length() const { return std::hypot(x2 - x1, y2 - y1); }
+
+  bool vertical() const { return (orientation & Vertical) != 0; }
+  bool horizontal() const { return (orientation & Horizontal) != 0; }
+  bool oblique() const { return orientation == 0; }
 
   double getAngle() const {
-    double angle = std::atan2(y2 - y1, x2 - x1) * 180.0 / M_PI;
+    double angle = std::atan2(static_cast<double>(y2) - y1,
+                              static_cast<double>(x2) - x1) *
+                   180.0 / M_PI;
     if (angle < 0)
       angle += 360;
     return angle;
@@ -63,23 +90,23 @@ struct Ruling : public Line {
     if (oblique())
       throw std::runtime_error("oblique rulings don't have position");
     if (vertical()) {
-      x1 = v;
-      x2 = v;
+      x1 = x2 = static_cast<float>(v);
     } else {
-      y1 = v;
-      y2 = v;
+      y1 = y2 = static_cast<float>(v);
     }
+    classify();
   }
   void setStartEnd(double s, double e) {
     if (oblique())
       throw std::runtime_error("oblique rulings don't have start/end");
     if (vertical()) {
-      y1 = s;
-      y2 = e;
+      y1 = static_cast<float>(s);
+      y2 = static_cast<float>(e);
     } else {
-      x1 = s;
-      x2 = e;
+      x1 = static_cast<float>(s);
+      x2 = static_cast<float>(e);
     }
+    classify();
   }
 
   Ruling expand(double amount) const {
@@ -192,6 +219,27 @@ struct Ruling : public Line {
     }
     return rv;
   }
+
+private:
+  enum : uint8_t { Horizontal = 1, Vertical = 2 };
+
+  float x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+  // Horizontal | Vertical bits; a very short ruling can be both, an oblique
+  // or zero-length one neither.
+  uint8_t orientation = 0;
+
+  void classify() {
+    orientation = 0;
+    if (length() > 0) {
+      if (Utils::feq(x1, x2))
+        orientation |= Vertical;
+      if (Utils::feq(y1, y2))
+        orientation |= Horizontal;
+    }
+  }
 };
 
+static_assert(std::is_trivially_copyable<Ruling>::value,
+              "Ruling is copied by value throughout the extractors");
+
 } // namespace tabula
@@ -0,0 +1,43 @@
+#pragma once
+#include "tabula/OrientedRuling.h"
+#include "tabula/Ruling.h"
+#include <cstdint>
+#include <vector>
+
+namespace tabula {
+
+// Ruling endpoints stored as four float arrays, with the cleanup kernels
+// RulingSet is built from: endpoint snapping (Utils::snapValues per axis)
+// and split + collapse by orientation.
+//
+// Sorting is a radix sort on the float bit patterns and the snap/collapse
+// passes are linear scans over contiguous arrays. Scratch space lives in the
+// buffer, so a buffer reused across pages stops allocating once it has seen
+// its largest page.
+class RulingBuffer {
+public:
+  void assign(const std::vector<Ruling> &rulings);
+  size_t size() const { return x1.size(); }
+
+  // Same result as Utils::snapPoints on the rulings.
+  void snap(float xThreshold, float yThreshold);
+
+  // Splits the rulings by orientation (as Ruling::horizontal()/vertical()
+  // classify them) and collapses each side like collapseRulings(). The
+  // output vectors are replaced.
+  void collapse(std::vector<HorizontalRuling> &horizontal,
+                std::vector<VerticalRuling> &vertical,
+                int expandAmount = 1);
+
+  std::vector<float> x1, y1, x2, y2;
+
+private:
+  std::vector<float> xs, ys;
+  std::vector<float> position, start, end;
+  std::vector<uint32_t> keys, order;
+
+  template <RulingOrientation O>
+  void collapseSide(std::vector<OrientedRuling<O>> &out, int expandAmount);
+};
+
+} // namespace tabula
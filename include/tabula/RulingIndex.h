@@ -0,0 +1,99 @@
+#pragma once
+#include "tabula/OrientedRuling.h"
+#include "tabula/Rectangle.h"
+#include "tabula/Ruling.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace tabula {
+
+// Rulings of one orientation sorted by position (then start), answering
+// "which rulings lie between these two positions" with a binary search.
+// Only the rulings inside the position range are then checked against the
+// extent, so a query costs O(log n) plus the rulings in that range (usually
+// none or one).
+template <RulingOrientation O> class RulingIndex {
+public:
+  typedef OrientedRuling<O> value_type;
+
+  RulingIndex() {}
+  explicit RulingIndex(std::vector<value_type> rulings)
+      : lines(std::move(rulings)) {
+    if (!std::is_sorted(lines.begin(), lines.end(), byPosition))
+      std::stable_sort(lines.begin(), lines.end(), byPosition);
+  }
+  // Keeps the rulings of this orientation and drops the rest.
+  explicit RulingIndex(const std::vector<Ruling> &rulings) {
+    for (const auto &r : rulings)
+      if (value_type::isVertical ? r.vertical() : r.horizontal())
+        lines.emplace_back(r);
+    std::stable_sort(lines.begin(), lines.end(), byPosition);
+  }
+
+  const std::vector<value_type> &rulings() const { return lines; }
+  size_t size() const { return lines.size(); }
+  bool empty() const { return lines.empty(); }
+  const value_type &operator[](size_t i) const { return lines[i]; }
+
+  // [first, last) of the rulings with lo <= position <= hi.
+  std::pair<size_t, size_t> positionRange(double lo, double hi) const {
+    auto first = std::lower_bound(
+        lines.begin(), lines.end(), lo,
+        [](const value_type &r, double v) { return r.position < v; });
+    auto last = std::upper_bound(
+        first, lines.end(), hi,
+        [](double v, const value_type &r) { return v < r.position; });
+    return std::make_pair(static_cast<size_t>(first - lines.begin()),
+                          static_cast<size_t>(last - lines.begin()));
+  }
+
+  // Whether a ruling lies strictly between positions lo and hi and its
+  // [start, end] overlaps [from, to] (touching counts).
+  bool anyBetween(double lo, double hi, double from, double to) const {
+    auto first = std::upper_bound(
+        lines.begin(), lines.end(), lo,
+        [](double v, const value_type &r) { return v < r.position; });
+    for (auto it = first; it != lines.end() && it->position < hi; ++it)
+      if (!(it->end < from || it->start > to))
+        return true;
+    return false;
+  }
+
+  // Ruling::cropRulingsToArea over the indexed rulings: those touching
+  // `area`, clipped to it, in index order.
+  std::vector<Ruling> cropToArea(const Rectangle &area) const {
+    const double left = area.getLeft(), right = area.getRight();
+    const double top = area.getTop(), bottom = area.getBottom();
+    const double from = value_type::isVertical ? top : left;
+    const double to = value_type::isVertical ? bottom : right;
+    auto range = value_type::isVertical ? positionRange(left, right)
+                                        : positionRange(top, bottom);
+    std::vector<Ruling> rv;
+    for (size_t i = range.first; i < range.second; ++i) {
+      const value_type &r = lines[i];
+      if (r.end < from || r.start > to)
+        continue;
+      const double s = std::max(static_cast<double>(r.start), from);
+      const double e = std::min(static_cast<double>(r.end), to);
+      if (value_type::isVertical)
+        rv.emplace_back(r.position, s, r.position, e);
+      else
+        rv.emplace_back(s, r.position, e, r.position);
+    }
+    return rv;
+  }
+
+private:
+  std::vector<value_type> lines;
+
+  static bool byPosition(const value_type &a, const value_type &b) {
+    return a.position < b.position ||
+           (a.position == b.position && a.start < b.start);
+  }
+};
+
+typedef RulingIndex<RulingOrientation::Horizontal> HorizontalRulingIndex;
+typedef RulingIndex<RulingOrientation::Vertical> VerticalRulingIndex;
+
+} // namespace tabula
@@ -0,0 +1,64 @@
+#pragma once
+#include "tabula/OrientedRuling.h"
+#include "tabula/Ruling.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tabula {
+
+// Crossings between horizontal and vertical rulings, as used by findCells.
+//
+// A horizontal and a vertical ruling cross when, with both expanded by 2pt
+// along their length, the vertical's x lies within the horizontal's span and
+// the horizontal's y within the vertical's (Ruling::intersectionPoint).
+// Verticals are sorted by x once; each horizontal then binary-searches the
+// verticals inside its span instead of testing all of them.
+//
+// Crossings are stored in an open-addressing hash table keyed by the point
+// snapped to a 1/1000pt integer grid. Each entry keeps the exact point and
+// the indices of the two rulings; when several pairs meet at the same point
+// the first one found (horizontals in input order, then verticals by x)
+// wins.
+class RulingIntersections {
+public:
+  struct Point {
+    double x, y;    // exact crossing point
+    int32_t kx, ky; // snapped key
+    uint32_t h, v;  // indices into the horizontal/vertical input vectors
+  };
+
+  static const size_t npos = static_cast<size_t>(-1);
+
+  RulingIntersections(const std::vector<HorizontalRuling> &horizontal,
+                      const std::vector<VerticalRuling> &vertical);
+  // Rulings of the wrong orientation in either list are skipped; h and v
+  // still index the vectors given here.
+  RulingIntersections(const std::vector<Ruling> &horizontal,
+                      const std::vector<Ruling> &vertical);
+
+  // Crossings in discovery order.
+  const std::vector<Point> &points() const { return pts; }
+  size_t size() const { return pts.size(); }
+
+  // Index into points() of the crossing at (x, y), or npos.
+  size_t find(double x, double y) const { return findKey(snap(x), snap(y)); }
+  size_t findKey(int32_t kx, int32_t ky) const;
+
+  // Horizontal/vertical pairs whose spans were compared.
+  uint64_t pairsTested() const { return tested; }
+
+  static int32_t snap(double v);
+
+private:
+  std::vector<Point> pts;
+  std::vector<uint32_t> slots; // index + 1 into pts, 0 = empty
+  uint64_t tested = 0;
+
+  static uint64_t hashKey(int32_t kx, int32_t ky);
+  void insert(const Point &p);
+  void build(const std::vector<HorizontalRuling> &horizontal,
+             const std::vector<VerticalRuling> &vertical);
+};
+
+} // namespace tabula
@@ -0,0 +1,46 @@
+#pragma once
+#include "tabula/OrientedRuling.h"
+#include "tabula/Ruling.h"
+#include "tabula/RulingIndex.h"
+#include <vector>
+
+namespace tabula {
+
+// The cleaned rulings of a page: endpoints snapped together, then split by
+// orientation and collapsed. Each array is sorted by position, then start.
+//
+// A RulingSet is built once per page (Page::getRulingSet) and never changes
+// afterwards, so the extractors, the detectors and the separator search can
+// all share it instead of re-collapsing the page's rulings themselves.
+class RulingSet {
+public:
+  RulingSet() {}
+  // Snaps endpoints closer than xThreshold/yThreshold (Utils::snapPoints)
+  // before collapsing.
+  RulingSet(const std::vector<Ruling> &rulings, float xThreshold,
+            float yThreshold);
+
+  const std::vector<HorizontalRuling> &getHorizontalRulings() const {
+    return horizontal.rulings();
+  }
+  const std::vector<VerticalRuling> &getVerticalRulings() const {
+    return vertical.rulings();
+  }
+  // the same arrays, for position range queries
+  const HorizontalRulingIndex &getHorizontalIndex() const { return horizontal; }
+  const VerticalRulingIndex &getVerticalIndex() const { return vertical; }
+
+  // The same rulings as plain Ruling values, verticals followed by
+  // horizontals.
+  const std::vector<Ruling> &getRulings() const { return all; }
+
+  bool empty() const { return all.empty(); }
+  size_t size() const { return all.size(); }
+
+private:
+  HorizontalRulingIndex horizontal;
+  VerticalRulingIndex vertical;
+  std::vector<Ruling> all;
+};
+
+} // namespace tabula
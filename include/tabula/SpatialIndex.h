@@ -0,0 +1,17 @@
+#pragma once
+#include "tabula/RectangleRTree.h"
+#include "tabula/RectangleSpatialIndex.h"
+
+namespace tabula {
+
+// Spatial index used by the extraction code. The uniform grid is the
+// default; build with -DTABULA_SPATIAL_RTREE (`make RTREE=1`) to use the
+// packed R-tree instead, which copes better with pages mixing page-sized
+// frames and glyph-sized boxes. Both share the same interface.
+#ifdef TABULA_SPATIAL_RTREE
+template <typename T> using SpatialIndex = RectangleRTree<T>;
+#else
+template <typename T> using SpatialIndex = RectangleSpatialIndex<T>;
+#endif
+
+} // namespace tabula
@@ -1,5 +1,6 @@
 #pragma once
 #include "tabula/Cell.h"
+#include "tabula/OrientedRuling.h"
 #include "tabula/Page.h"
 #include "tabula/Ruling.h"
 #include "tabula/Table.h"
@@ -13,6 +14,9 @@ public:
   // additional helper APIs (kept minimal for port)
   static std::vector<Cell> findCells(const std::vector<Ruling> &horizontal,
                                      const std::vector<Ruling> &vertical);
+  static std::vector<Cell>
+  findCells(const std::vector<HorizontalRuling> &horizontal,
+            const std::vector<VerticalRuling> &vertical);
   static std::vector<Rectangle>
   findSpreadsheetsFromCells(const std::vector<Rectangle> &cells);
 };
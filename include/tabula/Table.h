@@ -1,14 +1,42 @@
 #pragma once
 #include "tabula/Cell.h"
-#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <map>
+#include <string>
 #include <utility>
 #include <vector>
 
 namespace tabula {
 
+// Cells are kept in a dense row-major grid: the cell at (row, col) lives at
+// cells[row * stride + col], and slots nothing was added to hold a default
+// Cell. The stride grows geometrically when a wider row arrives. Should
+// the grid become mostly empty (a few cells far apart), the table moves
+// its cells into a map keyed by (row, col) instead and only lays out a
+// grid again when it is read.
+//
+// Readers get rows as views into the grid; getRows() still returns the
+// nested vectors, built as a copy on first use.
 class Table {
 public:
+  // getColCount() cells of one row, contiguous.
+  class RowView {
+  public:
+    RowView() : first(nullptr), count(0) {}
+    RowView(const Cell *first_, size_t count_)
+        : first(first_), count(count_) {}
+    const Cell *begin() const { return first; }
+    const Cell *end() const { return first + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Cell &operator[](size_t i) const { return first[i]; }
+
+  private:
+    const Cell *first;
+    size_t count;
+  };
+
   Table() = default;
 
   // page number metadata
@@ -31,32 +59,32 @@ public:
   void addRow(const std::vector<Cell> &row) {
     // append row to internal grid at next index
     int rowIndex = rowCount;
-    for (int c = 0; c < static_cast<int>(row.size()); ++c) {
+    for (int c = 0; c < static_cast<int>(row.size()); ++c)
       add(row[c], rowIndex, c);
-    }
+  }
+  void addRow(std::vector<Cell> &&row) {
+    int rowIndex = rowCount;
+    for (int c = 0; c < static_cast<int>(row.size()); ++c)
+      add(std::move(row[c]), rowIndex, c);
   }
 
   // Add a single cell at (row,col). Merges if a cell already exists at that
   // position.
-  void add(const Cell &cell, int row, int col) {
-    if (row < 0 || col < 0)
-      return;
-    rowCount = std::max(rowCount, row + 1);
-    colCount = std::max(colCount, col + 1);
-    std::pair<int, int> key(row, col);
-    auto it = cells.find(key);
-    if (it != cells.end()) {
-      // merge geometries and text elements into existing cell
-      it->second.mergeInPlace(cell);
-    } else {
-      cells.emplace(key, cell);
-    }
-    memoizedRows.clear();
-  }
+  void add(const Cell &cell, int row, int col) { add(Cell(cell), row, col); }
+  void add(Cell &&cell, int row, int col);
+  // Marks (row, col) as covered by a spanning cell. An empty slot becomes a
+  // placeholder cell with `bounds`; an occupied one grows to include them,
+  // as if an empty placeholder Cell had been added there.
+  void addPlaceholder(const Rectangle &bounds, int row, int col);
 
   int getRowCount() const { return rowCount; }
   int getColCount() const { return colCount; }
 
+  // Row `row` (empty when out of range); valid until the next add().
+  RowView getRow(int row) const;
+  // Whether a cell was added at (row, col).
+  bool hasCell(int row, int col) const;
+
   const std::vector<std::vector<Cell>> &getRows() const {
     if (memoizedRows.empty())
       computeRows();
@@ -64,22 +92,25 @@ public:
   }
 
 private:
-  void computeRows() const {
-    memoizedRows.clear();
-    memoizedRows.resize(rowCount);
-    for (int r = 0; r < rowCount; ++r) {
-      memoizedRows[r].resize(colCount);
-    }
-    for (auto const &p : cells) {
-      int r = p.first.first;
-      int c = p.first.second;
-      if (r < rowCount && c < colCount)
-        memoizedRows[r][c] = p.second;
-    }
-  }
+  void computeRows() const;
+  // The slot at (row, col), growing the grid as needed; `fresh` tells
+  // whether nothing had been added there yet. Null for negative indices.
+  Cell *slot(int row, int col, bool &fresh);
+  // Lays the dense grid out again with `newStride` columns per row.
+  void restride(int newStride);
+  void toSparse();
+
+  std::vector<Cell> cells;
+  std::vector<uint8_t> filled; // 1 where a cell was added
+  size_t filledCount = 0;
+  int stride = 0;
+  // sparse fallback, and the grid laid out from it for reading
+  bool sparse = false;
+  std::map<std::pair<int, int>, Cell> sparseCells;
+  mutable std::vector<Cell> sparseGrid;
+  mutable bool sparseGridBuilt = false;
 
   mutable std::vector<std::vector<Cell>> memoizedRows;
-  std::map<std::pair<int, int>, Cell> cells;
   int rowCount = 0;
   int colCount = 0;
   int pageNumber = 0;
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tabula {
+
+// A read-only run of UTF-8 bytes owned by someone else (a TextArena, or a
+// string that outlives the view).
+class TextView {
+public:
+  TextView() : ptr(nullptr), len(0) {}
+  TextView(const char *data, size_t size)
+      : ptr(data), len(static_cast<uint32_t>(size)) {}
+  explicit TextView(const std::string &s)
+      : ptr(s.data()), len(static_cast<uint32_t>(s.size())) {}
+
+  const char *data() const { return ptr; }
+  size_t size() const { return len; }
+  bool empty() const { return len == 0; }
+  const char *begin() const { return ptr; }
+  const char *end() const { return ptr + len; }
+  char operator[](size_t i) const { return ptr[i]; }
+  std::string str() const { return std::string(ptr, len); }
+
+  bool operator==(const TextView &o) const {
+    return len == o.len && std::char_traits<char>::compare(ptr, o.ptr, len) == 0;
+  }
+  bool operator!=(const TextView &o) const { return !(*this == o); }
+
+private:
+  const char *ptr;
+  uint32_t len;
+};
+
+// Bump allocator for the text of one page. Strings are copied into large
+// blocks and handed back as TextViews; a block is never moved or resized,
+// so views stay valid as the arena grows, until the arena is destroyed or
+// cleared. All of a page's text is then freed at once instead of string by
+// string.
+//
+// Not thread-safe; share a finished arena as std::shared_ptr<const
+// TextArena> to keep the views alive.
+class TextArena {
+public:
+  explicit TextArena(size_t blockSize = 64 * 1024);
+  TextArena(const TextArena &) = delete;
+  TextArena &operator=(const TextArena &) = delete;
+
+  TextView append(const char *s, size_t n);
+  TextView append(const std::string &s) { return append(s.data(), s.size()); }
+  TextView append(TextView v) { return append(v.data(), v.size()); }
+
+  // Builds one string from several pieces: each appendPart() extends the
+  // pending string and finish() returns it. The pieces end up contiguous
+  // even when they cross a block boundary. Don't call append() in between.
+  void appendPart(const char *s, size_t n);
+  void appendPart(TextView v) { appendPart(v.data(), v.size()); }
+  void appendPart(char c) { appendPart(&c, 1); }
+  TextView finish();
+
+  // Bytes handed out so far, and the blocks holding them.
+  size_t bytesUsed() const { return used; }
+  size_t blockCount() const { return blocks.size(); }
+
+  // Frees every block; all views into the arena become invalid.
+  void clear();
+
+private:
+  size_t blockSize;
+  std::vector<std::unique_ptr<char[]>> blocks;
+  char *cur = nullptr;  // next free byte of the last block
+  char *last = nullptr; // end of the last block
+  char *pending = nullptr; // start of the string appendPart() is building
+  bool building = false;
+  size_t used = 0;
+
+  char *reserve(size_t n);
+};
+
+} // namespace tabula
@@ -1,15 +1,12 @@
 #pragma once
 #include "tabula/RectangularTextContainer.h"
+#include "tabula/RulingIndex.h"
 #include "tabula/TextElement.h"
 #include <algorithm>
 #include <cmath>
 #include <string>
 #include <vector>
 
-namespace tabula {
-struct Ruling;
-}
-
 namespace tabula {
 
 class TextChunk : public RectangularTextContainer<TextElement> {
@@ -33,8 +30,10 @@ public:
     if (textElements.empty())
       return std::string();
     std::string sb;
-    for (auto const &te : textElements)
-      sb += te.getText();
+    for (auto const &te : textElements) {
+      const TextView text = te.getTextView();
+      sb.append(text.data(), text.size());
+    }
     return sb;
   }
   std::string getText(bool) const override { return getText(); }
@@ -47,24 +46,19 @@ public:
   // squeeze: split runs of char c of length >= minRunLength into boundaries
   // Produces TextChunks for regions between long runs of `c`. This approximates
   // per-character bounding boxes by dividing each TextElement width by its
-  // character count.
-  std::vector<TextChunk> squeeze(char c = ' ', int minRunLength = 2) const {
+  // character count. With an arena, the pieces' text is appended to it
+  // rather than held in strings of their own.
+  std::vector<TextChunk> squeeze(char c = ' ', int minRunLength = 2,
+                                 TextArena *arena = nullptr) const {
     std::vector<TextChunk> out;
     if (textElements.empty())
       return out;
 
-    struct CharInfo {
-      char ch;
-      float top;
-      float left;
-      float width;
-      float height;
-    };
     std::vector<CharInfo> chars;
     chars.reserve(256);
 
     for (const auto &te : textElements) {
-      std::string txt = te.getText();
+      const TextView txt = te.getTextView();
       int n = (int)txt.size();
       float elemWidth = te.getWidth();
       float charW = (n > 0) ? (elemWidth / static_cast<float>(std::max(1, n)))
@@ -119,14 +113,7 @@ public:
           top = std::min(top, chars[k].top);
           bottom = std::max(bottom, chars[k].top + chars[k].height);
         }
-        TextChunk tc(top, left, right - left, bottom - top);
-        std::string s;
-        s.reserve(b - a);
-        for (int k = a; k < b; ++k)
-          s.push_back(chars[k].ch);
-        TextElement te(top, left, right - left, bottom - top, s, 0.0f, 0.0f);
-        tc.add(te);
-        out.push_back(tc);
+        out.push_back(piece(chars, a, b, top, left, right, bottom, arena));
       }
       segStart = r.second;
     }
@@ -141,26 +128,52 @@ public:
         top = std::min(top, chars[k].top);
         bottom = std::max(bottom, chars[k].top + chars[k].height);
       }
-      TextChunk tc(top, left, right - left, bottom - top);
-      std::string s;
-      s.reserve(b - a);
-      for (int k = a; k < b; ++k)
-        s.push_back(chars[k].ch);
-      TextElement te(top, left, right - left, bottom - top, s, 0.0f, 0.0f);
-      tc.add(te);
-      out.push_back(tc);
+      out.push_back(piece(chars, a, b, top, left, right, bottom, arena));
     }
 
     return out;
   }
 
-  // Merge a flat list of TextElements into word-level TextChunks.
-  // Implemented in cpp/src/TextChunk.cpp. Accept a pointer to rulings to avoid
-  // instantiating std::vector<Ruling> in this header (Ruling is
-  // forward-declared).
+  // Merge a flat list of TextElements into word-level TextChunks, splitting
+  // words at vertical rulings that run between two glyphs.
+  // Implemented in cpp/src/TextChunk.cpp.
+  static std::vector<TextChunk>
+  mergeWords(const std::vector<TextElement> &elements,
+             const VerticalRulingIndex *verticalRulings);
+  // Indexes the vertical rulings first; prefer the overload above when the
+  // same rulings serve many calls.
   static std::vector<TextChunk>
   mergeWords(const std::vector<TextElement> &elements,
              const std::vector<Ruling> *verticalRulings = nullptr);
+
+private:
+  struct CharInfo {
+    char ch;
+    float top;
+    float left;
+    float width;
+    float height;
+  };
+
+  // One chunk holding chars [a, b) as a single element.
+  static TextChunk piece(const std::vector<CharInfo> &chars, int a, int b,
+                         float top, float left, float right, float bottom,
+                         TextArena *arena) {
+    TextChunk tc(top, left, right - left, bottom - top);
+    if (arena) {
+      for (int k = a; k < b; ++k)
+        arena->appendPart(chars[k].ch);
+      tc.add(TextElement(top, left, right - left, bottom - top,
+                         arena->finish(), 0.0f, 0.0f));
+    } else {
+      std::string s;
+      s.reserve(b - a);
+      for (int k = a; k < b; ++k)
+        s.push_back(chars[k].ch);
+      tc.add(TextElement(top, left, right - left, bottom - top, s, 0.0f, 0.0f));
+    }
+    return tc;
+  }
 };
 
 } // namespace tabula
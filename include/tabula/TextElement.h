@@ -1,28 +1,66 @@
 #pragma once
 #include "tabula/HasText.h"
 #include "tabula/Rectangle.h"
+#include "tabula/TextArena.h"
 #include <string>
 
 namespace tabula {
 
+// A glyph (or Poppler text box). Its text is either its own string or a
+// view into a TextArena; the pipeline builds elements over the page's arena
+// so that making, copying and grouping them allocates nothing per glyph.
+//
+// Copies of an arena-backed element view the same arena: they are only
+// valid while the arena is (for a page's elements, while the Page or a copy
+// of it is alive). Call ownText() on a copy that must outlive it. The text
+// is read with getText()/getTextView() and replaced with setText(); these
+// replace the former public `text` field.
 struct TextElement : public Rectangle, public HasText {
-  std::string text;
   float fontSize;
   float widthOfSpace;
   float dir;
 
-  TextElement() : Rectangle(), text(), fontSize(0), widthOfSpace(0), dir(0) {}
+  TextElement() : Rectangle(), fontSize(0), widthOfSpace(0), dir(0) {}
   TextElement(float y, float x, float width, float height, const std::string &c,
               float widthOfSpace_, float dir_ = 0.0f)
-      : Rectangle(y, x, width, height), text(c), fontSize(0),
-        widthOfSpace(widthOfSpace_), dir(dir_) {}
+      : Rectangle(y, x, width, height), fontSize(0),
+        widthOfSpace(widthOfSpace_), dir(dir_), ownedText(c) {}
+  // `c` must stay valid as long as this element and its copies (e.g. it
+  // lives in the page's TextArena).
+  TextElement(float y, float x, float width, float height, TextView c,
+              float widthOfSpace_, float dir_ = 0.0f)
+      : Rectangle(y, x, width, height), fontSize(0),
+        widthOfSpace(widthOfSpace_), dir(dir_), arenaText(c) {
+    if (!arenaText.data())
+      arenaText = TextView("", 0);
+  }
 
-  std::string getText() const override { return text; }
-  std::string getText(bool) const override { return text; }
+  TextView getTextView() const {
+    return arenaText.data() ? arenaText : TextView(ownedText);
+  }
+  std::string getText() const override { return getTextView().str(); }
+  std::string getText(bool) const override { return getText(); }
+  void setText(const std::string &c) {
+    ownedText = c;
+    arenaText = TextView();
+  }
+  // Whether the text lives in an arena rather than in the element.
+  bool viewsArena() const { return arenaText.data() != nullptr; }
+  // Copies arena-backed text into the element, detaching it from the arena.
+  void ownText() {
+    if (!arenaText.data())
+      return;
+    ownedText.assign(arenaText.data(), arenaText.size());
+    arenaText = TextView();
+  }
 
   float getDirection() const { return dir; }
   float getWidthOfSpace() const { return widthOfSpace; }
   float getFontSize() const { return fontSize; }
+
+private:
+  std::string ownedText; // used when arenaText is unset
+  TextView arenaText;
 };
 
 } // namespace tabula
@@ -0,0 +1,72 @@
+#pragma once
+#include "tabula/RulingIndex.h"
+#include "tabula/TextChunk.h"
+#include "tabula/TextElement.h"
+#include "tabula/TextStore.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tabula {
+
+// Geometry of a page's TextElements laid out once as flat arrays, plus the
+// line/word grouping that TextChunk::mergeWords performs.
+//
+// Element ids index the arrays and the TextStore the layout is built over
+// (for a Page they are the ids of Page::getTextElementIndex()). Grouping
+// works on id lists: lines and words come back as ranges over a reordered
+// id array, and the store is only read again for the text when the words
+// are written out. A cell therefore selects its element ids and groups
+// those, without copying elements or re-reading their geometry.
+class TextLayout {
+public:
+  struct Range {
+    uint32_t begin, end;
+  };
+
+  // Result of group(): `ids` ordered line by line, left to right within a
+  // line; `lines` and `words` are ranges over `ids`, words in reading order.
+  struct Grouping {
+    std::vector<uint32_t> ids;
+    std::vector<Range> lines;
+    std::vector<Range> words;
+  };
+
+  TextLayout() : textStore(std::make_shared<TextStore>()) {}
+  explicit TextLayout(std::shared_ptr<const TextStore> store);
+  // Copies the elements into a store of their own.
+  explicit TextLayout(const std::vector<TextElement> &elements);
+
+  size_t size() const { return top.size(); }
+  const TextStore &store() const { return *textStore; }
+  const std::shared_ptr<const TextStore> &sharedStore() const {
+    return textStore;
+  }
+  TextElement element(uint32_t id) const { return textStore->element(id); }
+
+  // Groups the elements `ids` (in page order) into lines and words exactly
+  // as TextChunk::mergeWords does: lines cluster on center y with a
+  // threshold of 0.6x their average height, words split on gaps wider than
+  // 1.5 spaces or at a vertical ruling between two glyphs.
+  void group(const std::vector<uint32_t> &ids,
+             const VerticalRulingIndex *verticalRulings, Grouping &out) const;
+
+  // Appends one element per word of `g` to `out`: the word's bounding box,
+  // and its glyphs' text joined by single spaces. Returns the new ids.
+  TextStore::Range appendWords(const Grouping &g, TextStore &out) const;
+
+  // One TextChunk per word of `g`, as TextChunk::mergeWords returns them.
+  std::vector<TextChunk> wordChunks(const Grouping &g) const;
+
+  std::vector<TextChunk> mergeWords(const std::vector<uint32_t> &ids,
+                                    const VerticalRulingIndex *verticalRulings)
+      const;
+
+private:
+  std::shared_ptr<const TextStore> textStore;
+  std::vector<float> top, left, right, bottom, height, centerY, space;
+
+  void layout();
+};
+
+} // namespace tabula
@@ -0,0 +1,94 @@
+#pragma once
+#include "tabula/TextElement.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tabula {
+
+// Text laid out flat: one geometry array, one element array and a single
+// byte array holding the text of every element back to back. Elements are
+// addressed by id (their position in the arrays), and a run of consecutive
+// elements by a Range, so chunks, cells and tables can refer to text
+// without owning a TextElement, and its std::string, per glyph.
+//
+// A store only grows. Ids and ranges handed out stay valid, so once built
+// it can be shared read-only (std::shared_ptr<const TextStore>) by all the
+// cells and tables that point into it.
+class TextStore {
+public:
+  struct Box {
+    float top, left, width, height;
+  };
+  struct Element {
+    uint32_t textBegin, textEnd; // [begin, end) of the byte array
+    float widthOfSpace, fontSize, dir;
+  };
+  struct Range {
+    uint32_t begin, end; // element ids [begin, end)
+    bool empty() const { return begin == end; }
+    uint32_t size() const { return end - begin; }
+  };
+
+  size_t size() const { return elements.size(); }
+  void reserve(size_t elementCount, size_t byteCount) {
+    boxes.reserve(elementCount);
+    elements.reserve(elementCount);
+    bytes.reserve(byteCount);
+  }
+
+  uint32_t add(const TextElement &te) {
+    const TextView text = te.getTextView();
+    appendText(text.data(), text.size());
+    return addElement(Box{te.getTop(), te.getLeft(), te.getWidth(),
+                          te.getHeight()},
+                      te.widthOfSpace, te.fontSize, te.dir);
+  }
+
+  // Text appended since the last addElement() becomes the text of the next
+  // element, so an element can be assembled from pieces in place.
+  void appendText(const char *s, size_t n) { bytes.append(s, n); }
+  void appendText(char c) { bytes.push_back(c); }
+  void appendText(const TextStore &from, uint32_t id) {
+    const Element &e = from.elements[id];
+    bytes.append(from.bytes, e.textBegin, e.textEnd - e.textBegin);
+  }
+  uint32_t addElement(const Box &box, float widthOfSpace = 0,
+                      float fontSize = 0, float dir = 0) {
+    const uint32_t begin = elements.empty() ? 0 : elements.back().textEnd;
+    boxes.push_back(box);
+    elements.push_back(Element{begin, static_cast<uint32_t>(bytes.size()),
+                               widthOfSpace, fontSize, dir});
+    return static_cast<uint32_t>(elements.size() - 1);
+  }
+
+  const Box &box(uint32_t id) const { return boxes[id]; }
+  const Element &info(uint32_t id) const { return elements[id]; }
+  const char *textData(uint32_t id) const {
+    return bytes.data() + elements[id].textBegin;
+  }
+  size_t textLength(uint32_t id) const {
+    return elements[id].textEnd - elements[id].textBegin;
+  }
+  std::string text(uint32_t id) const {
+    return std::string(textData(id), textLength(id));
+  }
+
+  // A standalone copy of element `id`.
+  TextElement element(uint32_t id) const {
+    const Box &b = boxes[id];
+    const Element &e = elements[id];
+    TextElement te(b.top, b.left, b.width, b.height, text(id),
+                   e.widthOfSpace, e.dir);
+    te.fontSize = e.fontSize;
+    return te;
+  }
+
+private:
+  std::vector<Box> boxes;
+  std::vector<Element> elements;
+  std::string bytes;
+};
+
+} // namespace tabula
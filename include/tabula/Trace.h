@@ -0,0 +1,68 @@
+#pragma once
+#include "tabula/Metrics.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace tabula {
+
+// Process-wide recorder of timed spans, written out in Chrome trace-event
+// format (load the file in chrome://tracing or Perfetto). Recording is off
+// by default; while tracing and metrics are off a TraceScope costs two
+// relaxed atomic loads.
+class Trace {
+public:
+  // Clear previously recorded spans and start recording.
+  static void start();
+  // Stop recording; recorded spans are kept until the next start().
+  static void stop();
+  static bool enabled();
+
+  // Record a finished span. `name` and `category` must be string literals
+  // (or otherwise outlive the trace); `page` is 1-based, <= 0 for none.
+  static void record(const char *name, const char *category, int64_t startUs,
+                     int64_t durationUs, int page);
+  // Microseconds since the trace clock's epoch.
+  static int64_t nowUs();
+
+  // Write recorded spans as {"traceEvents":[...]}.
+  static void writeJson(std::ostream &out);
+  static bool writeJson(const std::string &path);
+};
+
+// Times the enclosing scope; records it as a trace span when tracing is
+// enabled and as a stage latency sample when metrics are enabled.
+class TraceScope {
+public:
+  explicit TraceScope(const char *name, int page = 0,
+                      const char *category = "tabula")
+      : name_(name), category_(category), page_(page),
+        start_(Trace::enabled() || Metrics::enabled() ? Trace::nowUs() : -1) {}
+  ~TraceScope() {
+    if (start_ < 0)
+      return;
+    int64_t duration = Trace::nowUs() - start_;
+    if (Trace::enabled())
+      Trace::record(name_, category_, start_, duration, page_);
+    if (Metrics::enabled())
+      Metrics::observeStage(name_, duration / 1e6);
+  }
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+  const char *name_;
+  const char *category_;
+  int page_;
+  int64_t start_;
+};
+
+} // namespace tabula
+
+#define TABULA_TRACE_CONCAT_(a, b) a##b
+#define TABULA_TRACE_CONCAT(a, b) TABULA_TRACE_CONCAT_(a, b)
+// Trace the rest of the enclosing block: TABULA_TRACE_SCOPE("findCells") or
+// TABULA_TRACE_SCOPE("page", pageNumber).
+#define TABULA_TRACE_SCOPE(...)                                                \
+  ::tabula::TraceScope TABULA_TRACE_CONCAT(tabula_trace_scope_, __LINE__)(     \
+      __VA_ARGS__)
@@ -1,6 +1,8 @@
 #pragma once
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -113,100 +115,42 @@ struct Utils {
     return rv;
   }
 
+  // Order-preserving key for a float: a < b exactly when
+  // floatKey(a) < floatKey(b) (NaNs aside).
+  static uint32_t floatKey(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof bits);
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  }
+
+  // Stable LSD radix sort of the indices in `order` by keys[index]. Scratch
+  // space is kept per thread, so repeated calls don't allocate.
+  static void radixSortIndices(const std::vector<uint32_t> &keys,
+                               std::vector<uint32_t> &order);
+
+  // Snaps, in place, each run of values (in sorted order) lying within
+  // `threshold` of the run's smallest value to the run's average; positions
+  // are unchanged, only an index permutation is sorted.
+  static void snapValues(std::vector<float> &values, float threshold);
+
   // Snap endpoints of lines: group points within xThreshold/yThreshold and set
-  // them to group average
+  // them to group average. The x and y coordinates are snapped independently.
   template <typename LineT>
   static void snapPoints(std::vector<LineT> &rulings, float xThreshold,
                          float yThreshold) {
-    using PointT = std::pair<float, float>;
-    // collect points and map lines to their two points
-    struct LP {
-      LineT *line;
-      PointT p1;
-      PointT p2;
-    };
-    std::vector<LP> lps;
-    lps.reserve(rulings.size());
-    std::vector<PointT *> allPoints;
-
-    // We'll keep an array of points objects so we can mutate them
-    std::vector<PointT> points;
-    for (auto &r : rulings) {
-      PointT p1{static_cast<float>(r.x1), static_cast<float>(r.y1)};
-      PointT p2{static_cast<float>(r.x2), static_cast<float>(r.y2)};
-      points.push_back(p1);
-      points.push_back(p2);
-      lps.push_back(
-          LP{&r, points[points.size() - 2], points[points.size() - 1]});
-    }
-
-    if (points.empty())
-      return;
-
-    // helper: group by axis
-    auto group_and_snap = [&](bool byX) {
-      // create indices sorted by axis
-      std::vector<int> idx(points.size());
-      for (size_t i = 0; i < points.size(); ++i)
-        idx[i] = (int)i;
-      std::sort(idx.begin(), idx.end(), [&](int a, int b) {
-        return (byX ? points[a].first : points[a].second) <
-               (byX ? points[b].first : points[b].second);
-      });
-
-      std::vector<std::vector<int>> groups;
-      groups.emplace_back();
-      groups.back().push_back(idx[0]);
-      for (size_t k = 1; k < idx.size(); ++k) {
-        int cur = idx[k];
-        int last = groups.back()[0];
-        float curVal = byX ? points[cur].first : points[cur].second;
-        float lastVal = byX ? points[last].first : points[last].second;
-        if (std::fabs(curVal - lastVal) < (byX ? xThreshold : yThreshold)) {
-          groups.back().push_back(cur);
-        } else {
-          groups.emplace_back();
-          groups.back().push_back(cur);
-        }
-      }
-
-      for (auto &g : groups) {
-        float avg = 0.0f;
-        for (int ii : g)
-          avg += (byX ? points[ii].first : points[ii].second);
-        avg /= (float)g.size();
-        for (int ii : g) {
-          if (byX)
-            points[ii].first = avg;
-          else
-            points[ii].second = avg;
-        }
-      }
-    };
-
-    // snap X then Y
-    group_and_snap(true);
-    group_and_snap(false);
-
-    // write back into rulings by updating endpoint coordinates
-    size_t pi = 0;
-    for (auto &r : rulings) {
-      // each ruling had two points in sequence
-      r.x1 = points[pi].first;
-      r.y1 = points[pi].second;
-      r.x2 = points[pi + 1].first;
-      r.y2 = points[pi + 1].second;
-      // also update Rectangle-derived geometry
-      float newLeft = std::min(points[pi].first, points[pi + 1].first);
-      float newTop = std::min(points[pi].second, points[pi + 1].second);
-      float newRight = std::max(points[pi].first, points[pi + 1].first);
-      float newBottom = std::max(points[pi].second, points[pi + 1].second);
-      r.left = newLeft;
-      r.top = newTop;
-      r.width = newRight - newLeft;
-      r.height = newBottom - newTop;
-      pi += 2;
+    std::vector<float> xs, ys;
+    xs.reserve(2 * rulings.size());
+    ys.reserve(2 * rulings.size());
+    for (const auto &r : rulings) {
+      xs.push_back(static_cast<float>(r.getX1()));
+      xs.push_back(static_cast<float>(r.getX2()));
+      ys.push_back(static_cast<float>(r.getY1()));
+      ys.push_back(static_cast<float>(r.getY2()));
     }
+    snapValues(xs, xThreshold);
+    snapValues(ys, yThreshold);
+    for (size_t i = 0; i < rulings.size(); ++i)
+      rulings[i].setLine(xs[2 * i], ys[2 * i], xs[2 * i + 1], ys[2 * i + 1]);
   }
 };
 
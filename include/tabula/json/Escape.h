@@ -0,0 +1,23 @@
+// JSON string escaping shared by the serializers, the batch output and the
+// trace writer
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace tabula {
+namespace json {
+
+// Writes [s, s + n) escaped for a JSON string literal (without the quotes)
+// straight into `o`: quotes and backslashes get a backslash, control bytes
+// below 0x20 their short form (\b \t \n \f \r) or \u00XX. Other bytes,
+// UTF-8 included, are copied as is.
+void writeEscaped(std::ostream &o, const char *s, size_t n);
+inline void writeEscaped(std::ostream &o, const std::string &s) {
+  writeEscaped(o, s.data(), s.size());
+}
+// The same, returned as a string.
+std::string escape(const std::string &s);
+
+} // namespace json
+} // namespace tabula
@@ -40,4 +40,20 @@ inline std::vector<int> parsePagesSpec(const std::string &spec) {
   }
   return out;
 }
+
+// Zero-based indices of the pages of a `pageCount`-page document that
+// `pages` (as returned by parsePagesSpec) selects, in document order. An
+// empty `pages` selects every page.
+inline std::vector<int> selectPages(const std::vector<int> &pages,
+                                    int pageCount) {
+  std::vector<int> out;
+  for (int i = 0; i < pageCount; ++i) {
+    bool selected = pages.empty();
+    for (size_t k = 0; k < pages.size() && !selected; ++k)
+      selected = pages[k] == i;
+    if (selected)
+      out.push_back(i);
+  }
+  return out;
+}
 } // namespace tabula
@@ -1,7 +1,19 @@
 // Simple header to expose a run function for poppler-based extraction
 #pragma once
+#include <cstddef>
+#include <ostream>
 #include <string>
 #include <vector>
 
+// args[0] is the program name; the last positional argument is the PDF path
+// ("-" reads the document from stdin). Tables are written to std::cout.
 int poppler_integration_run(const std::vector<std::string> &args,
                             const std::vector<int> &pages = std::vector<int>());
+
+// Library entry point for PDFs already in memory: extracts from the caller's
+// bytes in place (no copy, no temp file) and writes tables to `out`. `args`
+// takes the same options as poppler_integration_run; any path is ignored.
+// The bytes only need to stay valid for the duration of the call.
+int poppler_integration_run_bytes(
+    const char *data, size_t size, const std::vector<std::string> &args,
+    std::ostream &out, const std::vector<int> &pages = std::vector<int>());
@@ -17,7 +17,13 @@ public:
   void write(std::ostream &out, const Table &table) const;
   void write(std::ostream &out, const std::vector<Table> &tables) const;
 
+  void begin(std::ostream &out);
+  void writeTable(std::ostream &out, const Table &table);
+  void end(std::ostream &out);
+
 private:
+  void writeOne(std::ostream &out, const Table &t, bool firstTable) const;
+
   char delim;
   bool includePageNumber;
   bool includeHeaderRow;
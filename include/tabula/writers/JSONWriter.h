@@ -12,6 +12,10 @@ class JSONWriter : public Writer {
 public:
   void write(std::ostream &out, const Table &table) const;
   void write(std::ostream &out, const std::vector<Table> &tables) const;
+
+  void begin(std::ostream &out);
+  void writeTable(std::ostream &out, const Table &table);
+  void end(std::ostream &out);
 };
 
 } // namespace writers
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <ostream>
 #include <vector>
 
@@ -15,6 +16,17 @@ public:
   virtual void write(std::ostream &out,
                      const std::vector<class Table> &tables) const = 0;
   // concrete writers may provide a convenience single-Table overload if desired
+
+  // Streaming interface: call begin() once, writeTable() for each table as
+  // soon as it has been extracted, then end() once. Output is identical to
+  // write(out, tables) but tables never have to be held all at once.
+  virtual void begin(std::ostream &out) = 0;
+  virtual void writeTable(std::ostream &out, const Table &table) = 0;
+  virtual void end(std::ostream &out) = 0;
+
+protected:
+  // number of tables emitted since the last begin()
+  size_t tablesWritten = 0;
 };
 
 } // namespace writers
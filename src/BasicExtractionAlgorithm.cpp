@@ -1,9 +1,11 @@
 #include "tabula/BasicExtractionAlgorithm.h"
 #include "tabula/Cell.h"
 #include "tabula/TableDetector.h"
-#include "tabula/TextChunk.h"
+#include "tabula/TextLayout.h"
+#include "tabula/Trace.h"
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace tabula {
@@ -11,6 +13,7 @@ namespace tabula {
 std::vector<Table> BasicExtractionAlgorithm::extract(const Page &page,
                                                      float minColumnWidth,
                                                      float minRowHeight) const {
+  TABULA_TRACE_SCOPE("basic.extract", page.getPageNumber());
   std::vector<Rectangle> rects =
       TableDetector::detectCells(page, minColumnWidth, minRowHeight);
   // Build a simple table: convert rectangles into rows by y coordinate
@@ -22,32 +25,31 @@ std::vector<Table> BasicExtractionAlgorithm::extract(const Page &page,
   for (auto const &r : rects)
     rows[r.getTop()].push_back(r);
 
+  const TextLayout &layout = page.getTextLayout();
+  TextLayout::Grouping grouping;
+  std::shared_ptr<TextStore> words = std::make_shared<TextStore>();
   Table table;
   for (auto const &pr : rows) {
     std::vector<Cell> rowCells;
     for (auto const &r : pr.second) {
       Cell c(r.getTop(), r.getLeft(), r.getWidth(), r.getHeight());
-      // Collect raw TextElements from the page that overlap this cell and
-      // merge into word-level TextChunks (mirror Java per-cell merge)
+      // Select the page's TextElements that overlap this cell and merge
+      // them into word-level TextChunks (mirror Java per-cell merge)
       try {
-        std::vector<TextElement> elems;
-        for (const auto &tc : page.getTextChunks()) {
-          for (const auto &te : tc.getTextElements()) {
-            if (te.overlapRatio(r) > 0.0f || r.overlapRatio(te) > 0.0f)
-              elems.push_back(te);
-          }
-        }
+        std::vector<uint32_t> elems = page.getTextElementIdsOverlapping(r);
         if (!elems.empty()) {
-          auto merged = TextChunk::mergeWords(elems, nullptr);
-          c.setTextElements(merged);
+          layout.group(elems, nullptr, grouping);
+          c.setText(words, layout.appendWords(grouping, *words));
         }
       } catch (...) {}
       rowCells.push_back(c);
     }
-    table.addRow(rowCells);
+    table.addRow(std::move(rowCells));
   }
 
-  return std::vector<Table>{table};
+  std::vector<Table> tables;
+  tables.push_back(std::move(table));
+  return tables;
 }
 
 } // namespace tabula
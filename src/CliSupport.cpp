@@ -0,0 +1,78 @@
+#include "tabula/CliSupport.h"
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+
+namespace tabula {
+namespace cli {
+
+void readManifest(std::istream &in, std::vector<std::string> &paths) {
+  std::string line;
+  while (std::getline(in, line)) {
+    auto b = line.find_first_not_of(" \t\r");
+    if (b == std::string::npos || line[b] == '#')
+      continue;
+    auto e = line.find_last_not_of(" \t\r");
+    paths.push_back(line.substr(b, e - b + 1));
+  }
+}
+
+bool readManifest(const std::string &file, std::vector<std::string> &paths) {
+  std::ifstream in(file);
+  if (!in)
+    return false;
+  readManifest(in, paths);
+  return true;
+}
+
+std::string outputFileFor(const std::string &dir, const std::string &path,
+                          const std::string &ext,
+                          std::set<std::string> &used) {
+  std::string base = path;
+  auto slash = base.find_last_of("/\\");
+  if (slash != std::string::npos)
+    base = base.substr(slash + 1);
+  auto dot = base.rfind('.');
+  if (dot != std::string::npos && dot > 0)
+    base = base.substr(0, dot);
+  if (base.empty() || base == "-")
+    base = "stdin";
+  std::string name = base;
+  for (int n = 2; !used.insert(name).second; ++n)
+    name = base + "-" + std::to_string(n);
+  return dir + "/" + name + "." + ext;
+}
+
+bool parseThreads(const std::string &spec, int &threads) {
+  // strtol would skip leading blanks and accept a sign
+  if (spec.empty() || !std::isdigit(static_cast<unsigned char>(spec[0])))
+    return false;
+  errno = 0;
+  char *end = nullptr;
+  const long n = std::strtol(spec.c_str(), &end, 10);
+  if (errno == ERANGE || *end != '\0' || n > INT_MAX)
+    return false;
+  threads = static_cast<int>(n);
+  return true;
+}
+
+CountingStreambuf::int_type CountingStreambuf::overflow(int_type c) {
+  if (traits_type::eq_int_type(c, traits_type::eof()))
+    return traits_type::not_eof(c);
+  if (traits_type::eq_int_type(dest_->sputc(traits_type::to_char_type(c)),
+                               traits_type::eof()))
+    return traits_type::eof();
+  ++count_;
+  return c;
+}
+
+std::streamsize CountingStreambuf::xsputn(const char *s, std::streamsize n) {
+  std::streamsize written = dest_->sputn(s, n);
+  count_ += static_cast<uint64_t>(written);
+  return written;
+}
+
+} // namespace cli
+} // namespace tabula
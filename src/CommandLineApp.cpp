@@ -1,20 +1,75 @@
-#include <algorithm>
+#include "tabula/CliSupport.h"
+#include "tabula/json/Escape.h"
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <set>
 #include <string>
 #include <vector>
 #ifdef HAVE_POPPLER
+#include "tabula/Metrics.h"
+#include "tabula/Trace.h"
 #include "tabula/pages.h"
 #include "tabula/poppler_integration.h"
-#include "tabula/writers/CSVWriter.h"
-#include "tabula/writers/JSONWriter.h"
+#endif
+
+#ifdef HAVE_POPPLER
+// Temporarily point std::cout at another buffer; restores it on scope exit
+// (including when extraction throws).
+struct CoutRedirect {
+  explicit CoutRedirect(std::streambuf *buf) : old(std::cout.rdbuf(buf)) {}
+  ~CoutRedirect() { std::cout.rdbuf(old); }
+  std::streambuf *old;
+};
+
+static int runOne(const std::vector<std::string> &args,
+                  const std::vector<int> &pages, std::ostream &out) {
+  CoutRedirect redirect(out.rdbuf());
+  return poppler_integration_run(args, pages);
+}
+
+// Records one trace for the whole run (every document of a batch) and
+// writes it when main returns.
+struct TraceSession {
+  explicit TraceSession(const std::string &p) : path(p) {
+    if (!path.empty())
+      tabula::Trace::start();
+  }
+  ~TraceSession() {
+    if (path.empty())
+      return;
+    tabula::Trace::stop();
+    if (!tabula::Trace::writeJson(path))
+      std::cerr << "Failed to write trace: " << path << std::endl;
+  }
+  std::string path;
+};
+
+// Same for metrics: collected over the whole run, written when main returns.
+struct MetricsSession {
+  explicit MetricsSession(const std::string &p) : path(p) {
+    if (!path.empty())
+      tabula::Metrics::start();
+  }
+  ~MetricsSession() {
+    if (path.empty())
+      return;
+    tabula::Metrics::stop();
+    if (!tabula::Metrics::writePrometheus(path))
+      std::cerr << "Failed to write metrics: " << path << std::endl;
+  }
+  std::string path;
+};
 #endif
 
 int main(int argc, char **argv) {
   if (argc < 2) {
     std::cerr << "Usage: tabula [--format json|csv] [--delimiter ,] "
                  "[--no-page] [--header] [--pages 1-3,5] [--area "
-                 "left,top,width,height] [--output file] <pdf-file>"
+                 "left,top,width,height] [--output file] [--threads N] "
+                 "[--batch manifest.txt] [--output-dir dir] [--trace out.json] "
+                 "[--metrics out.prom] "
+                 "<pdf-file|->..."
               << std::endl;
     return 2;
   }
@@ -26,7 +81,12 @@ int main(int argc, char **argv) {
   std::string pagesSpec;
   std::string areaSpec;
   std::string outputPath;
-  std::string path;
+  std::string outputDir;
+  std::string threadsSpec;
+  std::string tracePath;
+  std::string metricsPath;
+  std::vector<std::string> paths;
+  bool batch = false;
 
   for (int i = 1; i < argc; ++i) {
     std::string a = argv[i];
@@ -44,18 +104,44 @@ int main(int argc, char **argv) {
       areaSpec = argv[++i];
     } else if (a == "--output" && i + 1 < argc) {
       outputPath = argv[++i];
+    } else if (a == "--output-dir" && i + 1 < argc) {
+      outputDir = argv[++i];
+    } else if (a == "--threads" && i + 1 < argc) {
+      threadsSpec = argv[++i];
+      int threads = 0;
+      if (!tabula::cli::parseThreads(threadsSpec, threads)) {
+        std::cerr << "Invalid --threads value: " << threadsSpec << std::endl;
+        return 2;
+      }
+    } else if (a == "--trace" && i + 1 < argc) {
+      tracePath = argv[++i];
+    } else if (a == "--metrics" && i + 1 < argc) {
+      metricsPath = argv[++i];
+    } else if (a == "--batch" && i + 1 < argc) {
+      std::string manifest = argv[++i];
+      if (!tabula::cli::readManifest(manifest, paths)) {
+        std::cerr << "Failed to read batch manifest: " << manifest
+                  << std::endl;
+        return 2;
+      }
+      batch = true;
     } else if (a.rfind("--", 0) == 0) {
       std::cerr << "Unknown option: " << a << std::endl;
       return 2;
     } else {
-      path = a;
+      paths.push_back(a);
     }
   }
 
-  if (path.empty()) {
+  if (paths.empty()) {
     std::cerr << "Missing PDF path" << std::endl;
     return 2;
   }
+  if (!outputPath.empty() && !outputDir.empty()) {
+    std::cerr << "--output and --output-dir cannot be used together"
+              << std::endl;
+    return 2;
+  }
 
 #ifdef HAVE_POPPLER
   // Delegate to poppler integration code path (reuse its logic)
@@ -79,27 +165,120 @@ int main(int argc, char **argv) {
     args.push_back("--area");
     args.push_back(areaSpec);
   }
-  args.push_back(path);
+  if (!threadsSpec.empty()) {
+    args.push_back("--threads");
+    args.push_back(threadsSpec);
+  }
   auto pages = tabula::parsePagesSpec(pagesSpec);
-  // If outputPath specified, redirect std::cout temporarily
-  if (!outputPath.empty()) {
-    std::ofstream fout(outputPath, std::ios::binary);
-    if (!fout) {
+  TraceSession trace(tracePath);
+  MetricsSession metrics(metricsPath);
+
+  if (!batch && paths.size() == 1 && outputDir.empty()) {
+    args.push_back(paths.front());
+    // If outputPath specified, redirect std::cout temporarily
+    if (!outputPath.empty()) {
+      std::ofstream fout(outputPath, std::ios::binary);
+      if (!fout) {
+        std::cerr << "Failed to open output file: " << outputPath << std::endl;
+        return 2;
+      }
+      return runOne(args, pages, fout);
+    }
+    return poppler_integration_run(args, pages);
+  }
+
+  // Batch mode: every document is extracted in this process (Poppler and
+  // font configuration are initialised once). Each document goes either to
+  // its own file in --output-dir, or into one combined stream where it is
+  // tagged with its path: one JSON object per line
+  // ({"file":...,"tables":[...]}) for JSON, and a "# file: <path>" line
+  // before each document for CSV. Documents are streamed as they are
+  // extracted. A failing document is reported and the run continues; its
+  // record is closed with an error marker after whatever it had written
+  // ("# error: ..." for CSV; for JSON an "error" member, with "tables"
+  // null if nothing was written).
+  std::ofstream combinedFile;
+  std::ostream *combined = &std::cout;
+  if (outputDir.empty() && !outputPath.empty()) {
+    combinedFile.open(outputPath, std::ios::binary);
+    if (!combinedFile) {
       std::cerr << "Failed to open output file: " << outputPath << std::endl;
       return 2;
     }
-    auto *oldbuf = std::cout.rdbuf(fout.rdbuf());
-    int rc = poppler_integration_run(args, pages);
-    std::cout.rdbuf(oldbuf);
-    return rc;
+    combined = &combinedFile;
   }
-  return poppler_integration_run(args, pages);
+  const bool csv = (format == "csv");
+  std::set<std::string> usedNames;
+  size_t failed = 0;
+  for (const auto &path : paths) {
+    std::vector<std::string> docArgs = args;
+    docArgs.push_back(path);
+    int rc = 0;
+    std::string error;
+    if (outputDir.empty()) {
+      if (csv)
+        *combined << "# file: " << path << "\n";
+      else
+        *combined << "{\"file\":\"" << tabula::json::escape(path)
+                  << "\",\"tables\":";
+    }
+    tabula::cli::CountingStreambuf written(combined->rdbuf());
+    try {
+      if (!outputDir.empty()) {
+        std::string outFile = tabula::cli::outputFileFor(
+            outputDir, path, csv ? "csv" : "json", usedNames);
+        std::ofstream dout(outFile, std::ios::binary);
+        if (!dout) {
+          rc = 2;
+          error = "failed to open output file " + outFile;
+        } else {
+          rc = runOne(docArgs, pages, dout);
+        }
+      } else {
+        std::ostream docOut(&written);
+        rc = runOne(docArgs, pages, docOut);
+      }
+    } catch (const std::exception &e) {
+      rc = 1;
+      error = e.what();
+    } catch (...) {
+      rc = 1;
+      error = "unknown error";
+    }
+    if (rc != 0 && error.empty())
+      error = "extraction failed with code " + std::to_string(rc);
+    if (rc != 0) {
+      ++failed;
+      std::cerr << "tabula: " << path << ": " << error << std::endl;
+    }
+    if (!outputDir.empty())
+      continue;
+    if (csv) {
+      if (rc != 0)
+        *combined << "# error: " << error << "\n";
+    } else {
+      // the JSON writer emits whole tables, so a document that failed
+      // part-way has written "[" and zero or more comma-separated tables
+      if (rc != 0)
+        *combined << (written.count() == 0 ? "null" : "]") << ",\"error\":\""
+                  << tabula::json::escape(error) << "\"";
+      *combined << "}\n";
+    }
+    combined->flush();
+  }
+  std::cerr << "tabula: processed " << paths.size() << " document(s), "
+            << failed << " failed" << std::endl;
+  return failed == 0 ? 0 : 1;
 #else
   // silence unused variable warnings when built without Poppler
   (void)delim;
   (void)includePage;
   (void)includeHeader;
   (void)format;
+  (void)threadsSpec;
+  (void)batch;
+  (void)tracePath;
+  (void)metricsPath;
   std::cerr << "tabula-cli: built without Poppler support. Configure with "
                "-DUSE_XPDF=ON and install poppler-cpp."
             << std::endl;
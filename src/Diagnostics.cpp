@@ -0,0 +1,4 @@
+#include "tabula/Diagnostics.h"
+
+// Diagnostics flag default
+bool tabula::diagnostics_enabled = false;
@@ -0,0 +1,154 @@
+#include "tabula/Metrics.h"
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace tabula {
+
+namespace {
+
+struct CounterInfo {
+  const char *name;
+  const char *help;
+};
+
+const CounterInfo counterInfo[Metrics::CounterCount] = {
+    {"tabula_pages_processed_total", "Pages run through the extraction pipeline."},
+    {"tabula_text_elements_total", "TextElements built from Poppler text boxes."},
+    {"tabula_rulings_before_collapse_total", "Rulings on a page before snapping and collapsing."},
+    {"tabula_rulings_after_collapse_total", "Horizontal and vertical rulings left after collapsing."},
+    {"tabula_intersections_tested_total", "Horizontal/vertical ruling pairs compared in findCells."},
+    {"tabula_cells_found_total", "Cells found by the spreadsheet extractor."},
+    {"tabula_tables_emitted_total", "Tables handed to the writer."},
+    {"tabula_bytes_written_total", "Bytes of table output written."},
+};
+
+const std::vector<double> latencyBuckets = {0.0001, 0.0005, 0.001, 0.005,
+                                            0.01,   0.05,   0.1,   0.5,
+                                            1.0,    5.0,    10.0};
+const std::vector<double> elementBuckets = {10,    50,    100,   500,
+                                            1000,  5000,  10000, 50000};
+
+struct Histogram {
+  explicit Histogram(const std::vector<double> &b)
+      : bounds(&b), buckets(b.size(), 0), sum(0), count(0) {}
+  void observe(double v) {
+    for (size_t i = 0; i < bounds->size(); ++i)
+      if (v <= (*bounds)[i])
+        ++buckets[i];
+    sum += v;
+    ++count;
+  }
+  // Buckets are stored cumulatively, as Prometheus expects.
+  void write(std::ostream &out, const std::string &name,
+             const std::string &labels) const {
+    std::string sep = labels.empty() ? "" : ",";
+    for (size_t i = 0; i < bounds->size(); ++i)
+      out << name << "_bucket{" << labels << sep << "le=\"" << (*bounds)[i]
+          << "\"} " << buckets[i] << "\n";
+    out << name << "_bucket{" << labels << sep << "le=\"+Inf\"} " << count
+        << "\n";
+    std::string braces = labels.empty() ? "" : "{" + labels + "}";
+    // full precision: the default 6 digits would round large sums
+    const std::streamsize precision =
+        out.precision(std::numeric_limits<double>::max_digits10);
+    out << name << "_sum" << braces << " " << sum << "\n";
+    out.precision(precision);
+    out << name << "_count" << braces << " " << count << "\n";
+  }
+
+  const std::vector<double> *bounds;
+  std::vector<uint64_t> buckets;
+  double sum;
+  uint64_t count;
+};
+
+std::atomic<bool> metricsEnabled(false);
+std::atomic<uint64_t> counters[Metrics::CounterCount];
+std::mutex histogramMutex;
+std::map<std::string, Histogram> stageLatency;
+Histogram textElementsPerPage(elementBuckets);
+
+} // namespace
+
+void Metrics::start() {
+  reset();
+  metricsEnabled.store(true, std::memory_order_relaxed);
+}
+
+void Metrics::stop() { metricsEnabled.store(false, std::memory_order_relaxed); }
+
+bool Metrics::enabled() {
+  return metricsEnabled.load(std::memory_order_relaxed);
+}
+
+void Metrics::reset() {
+  for (auto &c : counters)
+    c.store(0, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(histogramMutex);
+  stageLatency.clear();
+  textElementsPerPage = Histogram(elementBuckets);
+}
+
+void Metrics::add(Counter c, uint64_t n) {
+  counters[c].fetch_add(n, std::memory_order_relaxed);
+}
+
+uint64_t Metrics::value(Counter c) {
+  return counters[c].load(std::memory_order_relaxed);
+}
+
+void Metrics::observeStage(const char *stage, double seconds) {
+  std::lock_guard<std::mutex> lock(histogramMutex);
+  auto it = stageLatency.find(stage);
+  if (it == stageLatency.end())
+    it = stageLatency.insert(std::make_pair(std::string(stage),
+                                            Histogram(latencyBuckets)))
+             .first;
+  it->second.observe(seconds);
+}
+
+void Metrics::observeTextElementsPerPage(uint64_t n) {
+  std::lock_guard<std::mutex> lock(histogramMutex);
+  textElementsPerPage.observe(static_cast<double>(n));
+}
+
+uint64_t Metrics::stageCount(const std::string &stage) {
+  std::lock_guard<std::mutex> lock(histogramMutex);
+  auto it = stageLatency.find(stage);
+  return it == stageLatency.end() ? 0 : it->second.count;
+}
+
+void Metrics::writePrometheus(std::ostream &out) {
+  for (int c = 0; c < CounterCount; ++c) {
+    out << "# HELP " << counterInfo[c].name << " " << counterInfo[c].help
+        << "\n";
+    out << "# TYPE " << counterInfo[c].name << " counter\n";
+    out << counterInfo[c].name << " " << value(static_cast<Counter>(c))
+        << "\n";
+  }
+  std::lock_guard<std::mutex> lock(histogramMutex);
+  out << "# HELP tabula_text_elements_per_page TextElements on each processed "
+         "page.\n";
+  out << "# TYPE tabula_text_elements_per_page histogram\n";
+  textElementsPerPage.write(out, "tabula_text_elements_per_page", "");
+  out << "# HELP tabula_stage_duration_seconds Wall time of each pipeline "
+         "stage run.\n";
+  out << "# TYPE tabula_stage_duration_seconds histogram\n";
+  for (const auto &kv : stageLatency)
+    kv.second.write(out, "tabula_stage_duration_seconds",
+                    "stage=\"" + kv.first + "\"");
+}
+
+bool Metrics::writePrometheus(const std::string &path) {
+  std::ofstream out(path, std::ios::binary);
+  if (!out)
+    return false;
+  writePrometheus(out);
+  return static_cast<bool>(out);
+}
+
+} // namespace tabula
@@ -6,12 +6,11 @@ namespace tabula {
 
 Page ObjectExtractor::extractPage(int pageNumber) {
   Page p(pageNumber);
+  p.setTextArena(arena_);
 
   // If an engine is provided, copy rulings
-  if (engine_) {
-    for (const auto &r : engine_->getRulings())
-      p.addRuling(r);
-  }
+  if (engine_)
+    p.addRulings(engine_->getRulings());
 
   // Use stripper to group elements into chunks
   auto chunks = stripper_.strip(elements_);
@@ -1,4 +1,3 @@
-#ifdef HAVE_POPPLER
 #include "tabula/ObjectExtractorPopplerEngine.h"
 #include "tabula/Rectangle.h"
 #include "tabula/Diagnostics.h"
@@ -8,42 +7,26 @@
 
 namespace tabula {
 
-// Build rulings by clustering TextChunk geometry positions. This avoids
-// relying on poppler render APIs and produces rulings where many chunks
-// align along a vertical/horizontal position.
-void ObjectExtractorPopplerEngine::analyze(poppler::page &p) {
+// Build rulings by clustering text box positions. This avoids relying on
+// poppler render APIs and produces rulings where many boxes align along a
+// vertical/horizontal position.
+void ObjectExtractorPopplerEngine::analyze(const PageSnapshot &snapshot) {
   try {
-    // Use text chunks from the page to propose ruling positions
-    // We need a Page object to get text chunks; but poppler_integration
-    // constructs ObjectExtractor with elements and then calls extractPage()
-    // which uses engine_->getRulings(). To allow clustering we need to
-    // access the poppler page directly: gather textual bounding boxes via
-    // poppler::page::text_list() and map them to top/left/right/bottom.
-
-    auto text_list = p.text_list();
+    // The snapshot holds the page's text boxes already flipped to top-left
+    // coordinates; the same snapshot feeds the TextElement builder, so
+    // Poppler only lays out the page text once.
     std::vector<double> xs;
     std::vector<double> ys;
-    double page_h = 0.0, page_w = 0.0;
-    try {
-      auto rect = p.page_rect();
-      page_h = rect.height();
-      page_w = rect.width();
-    } catch (...) {}
-    for (const auto &item : text_list) {
-      try {
-        auto r = item.bbox();
-        double left = static_cast<double>(r.left());
-        double width = static_cast<double>(r.width());
-        double top_raw = static_cast<double>(r.top());
-        double height = static_cast<double>(r.height());
-        double top = (page_h > 0.0) ? (page_h - (top_raw + height)) : top_raw;
-        double right = left + width;
-        double bottom = top + height;
-        xs.push_back(left);
-        xs.push_back(right);
-        ys.push_back(top);
-        ys.push_back(bottom);
-      } catch (...) {}
+    xs.reserve(snapshot.boxes.size() * 2);
+    ys.reserve(snapshot.boxes.size() * 2);
+    double page_h = snapshot.height, page_w = snapshot.width;
+    for (const auto &b : snapshot.boxes) {
+      double left = static_cast<double>(b.left);
+      double top = static_cast<double>(b.top);
+      xs.push_back(left);
+      xs.push_back(left + static_cast<double>(b.width));
+      ys.push_back(top);
+      ys.push_back(top + static_cast<double>(b.height));
     }
 
     auto cluster = [](std::vector<double> &vals, double tol) {
@@ -78,12 +61,10 @@ void ObjectExtractorPopplerEngine::analyze(poppler::page &p) {
       Ruling hr(0.0, y, static_cast<double>(page_w > 0.0 ? page_w : 1000.0), y);
       this->addSegment(static_cast<float>(hr.getLeft()), static_cast<float>(hr.getTop()), static_cast<float>(hr.getRight()), static_cast<float>(hr.getBottom()));
     }
-  tabula::diag(std::string("[diag] engine clustered rulings vx=") + std::to_string(vx.size()) + " vy=" + std::to_string(vy.size()));
+  TABULA_DIAG(std::string("[diag] engine clustered rulings vx=") + std::to_string(vx.size()) + " vy=" + std::to_string(vy.size()));
   } catch (const std::exception &e) {
-  tabula::diag(std::string("[diag] engine analyze error: ") + e.what());
+  TABULA_DIAG(std::string("[diag] engine analyze error: ") + e.what());
   } catch (...) {}
 }
 
 } // namespace tabula
-#endif
-
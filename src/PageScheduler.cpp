@@ -0,0 +1,87 @@
+#include "tabula/PageScheduler.h"
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace tabula {
+
+void extractInPageOrder(size_t n, int threads,
+                        const std::function<PageExtractor()> &makeWorker,
+                        const std::function<void(std::vector<Table> &)> &emit) {
+  const size_t window = static_cast<size_t>(threads) * 4;
+  std::vector<std::vector<Table>> slots(n);
+  std::vector<char> ready(n, 0);
+  size_t nextPage = 0;
+  size_t emitted = 0;
+  bool failed = false;
+  std::exception_ptr error;
+  std::mutex m;
+  std::condition_variable cv;
+
+  auto fail = [&](std::exception_ptr e) {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      if (!failed) {
+        failed = true;
+        error = e;
+      }
+    }
+    cv.notify_all();
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (int w = 0; w < threads; ++w) {
+    workers.emplace_back([&]() {
+      try {
+        PageExtractor extract = makeWorker();
+        for (;;) {
+          size_t k;
+          {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [&]() {
+              return failed || nextPage >= n || nextPage < emitted + window;
+            });
+            if (failed || nextPage >= n)
+              return;
+            k = nextPage++;
+          }
+          std::vector<Table> tables = extract(k);
+          {
+            std::lock_guard<std::mutex> lock(m);
+            slots[k] = std::move(tables);
+            ready[k] = 1;
+          }
+          cv.notify_all();
+        }
+      } catch (...) {
+        fail(std::current_exception());
+      }
+    });
+  }
+
+  try {
+    for (size_t k = 0; k < n; ++k) {
+      std::vector<Table> tables;
+      {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&]() { return failed || ready[k]; });
+        if (failed)
+          break;
+        tables.swap(slots[k]);
+        emitted = k + 1;
+      }
+      cv.notify_all();
+      emit(tables);
+    }
+  } catch (...) {
+    fail(std::current_exception());
+  }
+  for (auto &t : workers)
+    t.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+} // namespace tabula
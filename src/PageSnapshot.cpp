@@ -0,0 +1,57 @@
+#include "tabula/PageSnapshot.h"
+
+namespace tabula {
+
+std::vector<TextElement> PageSnapshot::toTextElements() const {
+  std::vector<TextElement> out;
+  out.reserve(boxes.size());
+  for (const auto &b : boxes)
+    out.emplace_back(b.top, b.left, b.width, b.height, b.text,
+                     b.height * 0.25f);
+  return out;
+}
+
+std::vector<TextElement> PageSnapshot::toTextElements(TextArena &arena) const {
+  std::vector<TextElement> out;
+  out.reserve(boxes.size());
+  for (const auto &b : boxes)
+    out.emplace_back(b.top, b.left, b.width, b.height, arena.append(b.text),
+                     b.height * 0.25f);
+  return out;
+}
+
+#ifdef HAVE_POPPLER
+PageSnapshot PageSnapshot::fromPoppler(poppler::page &p) {
+  PageSnapshot snap;
+  try {
+    auto rect = p.page_rect();
+    snap.width = static_cast<float>(rect.width());
+    snap.height = static_cast<float>(rect.height());
+  } catch (...) {
+  }
+  auto text_list = p.text_list();
+  snap.boxes.reserve(text_list.size());
+  for (const auto &item : text_list) {
+    try {
+      auto ba = item.text().to_utf8();
+      auto r = item.bbox();
+      // Poppler uses a coordinate system with origin at bottom-left; convert
+      // to our top-left origin by flipping Y using the page height.
+      TextBox b;
+      b.left = static_cast<float>(r.left());
+      b.height = static_cast<float>(r.height());
+      float raw_top = static_cast<float>(r.top());
+      b.top = (snap.height > 0.0f) ? (snap.height - (raw_top + b.height))
+                                   : raw_top;
+      b.width = static_cast<float>(r.width());
+      b.text.assign(ba.begin(), ba.end());
+      snap.boxes.push_back(std::move(b));
+    } catch (...) {
+      // ignore any item we can't process
+    }
+  }
+  return snap;
+}
+#endif
+
+} // namespace tabula
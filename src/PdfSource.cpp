@@ -0,0 +1,94 @@
+#include "tabula/PdfSource.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TABULA_HAVE_MMAP 1
+#else
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace tabula {
+
+PdfSource::~PdfSource() {
+#ifdef TABULA_HAVE_MMAP
+  if (mapped_ && size_ > 0)
+    munmap(const_cast<char *>(data_), size_);
+#endif
+}
+
+std::unique_ptr<PdfSource> PdfSource::fromFile(const std::string &path) {
+#ifdef TABULA_HAVE_MMAP
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    // not a regular file (e.g. a named pipe): fall back to reading it
+    std::ifstream in(path, std::ios::binary);
+    return in ? fromStream(in) : nullptr;
+  }
+  std::unique_ptr<PdfSource> src(new PdfSource());
+  if (st.st_size > 0) {
+    void *p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                   MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+      return nullptr;
+    // pages are consumed front to back by the parser after it reads the
+    // trailer; let the kernel read ahead
+    madvise(p, static_cast<size_t>(st.st_size), MADV_WILLNEED);
+    src->data_ = static_cast<const char *>(p);
+    src->size_ = static_cast<size_t>(st.st_size);
+    src->mapped_ = true;
+  } else {
+    ::close(fd);
+  }
+  return src;
+#else
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return nullptr;
+  return fromStream(in);
+#endif
+}
+
+std::unique_ptr<PdfSource> PdfSource::fromStream(std::istream &in) {
+  std::unique_ptr<PdfSource> src(new PdfSource());
+  char buf[64 * 1024];
+  while (in) {
+    in.read(buf, sizeof(buf));
+    src->owned_.insert(src->owned_.end(), buf, buf + in.gcount());
+  }
+  if (in.bad())
+    return nullptr;
+  src->data_ = src->owned_.data();
+  src->size_ = src->owned_.size();
+  return src;
+}
+
+std::unique_ptr<PdfSource> PdfSource::fromBuffer(const char *data,
+                                                 size_t size) {
+  std::unique_ptr<PdfSource> src(new PdfSource());
+  src->data_ = data;
+  src->size_ = size;
+  return src;
+}
+
+std::unique_ptr<PdfSource> PdfSource::open(const std::string &path) {
+  if (path == "-") {
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    return fromStream(std::cin);
+  }
+  return fromFile(path);
+}
+
+} // namespace tabula
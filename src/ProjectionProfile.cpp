@@ -1,4 +1,5 @@
 #include "tabula/ProjectionProfile.h"
+#include <algorithm>
 #include <cmath>
 
 namespace tabula {
@@ -126,77 +127,76 @@ std::vector<float> ProjectionProfile::findHorizontalSeparators() const {
 
 std::vector<float>
 ProjectionProfile::findVerticalSeparators(float minColumnWidth) const {
-  return findVerticalSeparators(minColumnWidth, std::vector<Ruling>());
+  return findVerticalSeparators(minColumnWidth, VerticalRulingIndex());
 }
 
 std::vector<float>
 ProjectionProfile::findHorizontalSeparators(float minRowHeight) const {
-  return findHorizontalSeparators(minRowHeight, std::vector<Ruling>());
+  return findHorizontalSeparators(minRowHeight, HorizontalRulingIndex());
 }
 
 std::vector<float> ProjectionProfile::findVerticalSeparators(
     float minColumnWidth, const std::vector<Ruling> &explicitRulings) const {
+  return findVerticalSeparators(minColumnWidth,
+                                VerticalRulingIndex(explicitRulings));
+}
+
+std::vector<float> ProjectionProfile::findVerticalSeparators(
+    float minColumnWidth, const VerticalRulingIndex &explicitRulings) const {
+  // Add explicit full-length vertical rulings similar to Java; the index is
+  // sorted by x, so these come out sorted too
   std::vector<int> verticalSeparators;
-  // Add explicit full-length vertical rulings similar to Java
-  for (const auto &r : explicitRulings) {
-    if (r.vertical()) {
-      if (r.length() / areaHeight_ >= 0.95)
-        verticalSeparators.push_back(toFixed(r.getPosition() - areaLeft_));
-    }
+  for (const auto &r : explicitRulings.rulings()) {
+    if (r.length() / areaHeight_ >= 0.95)
+      verticalSeparators.push_back(toFixed(r.getPosition() - areaLeft_));
   }
 
   // derivative of vertical projection (height-wise) -> horizontal separators
   auto deriv = getFirstDeriv(verticalProjection_);
   auto seps = findSeparatorsFromProjection(filter(deriv, 0.1f));
-
-  for (int foundSep : seps) {
-    bool foundNarrower = false;
-    for (int explicitSep : verticalSeparators) {
-      if (std::abs(toDouble(foundSep - explicitSep)) <= minColumnWidth) {
-        foundNarrower = true;
-        break;
-      }
-    }
-    if (!foundNarrower)
-      verticalSeparators.push_back(foundSep);
-  }
-  std::sort(verticalSeparators.begin(), verticalSeparators.end());
-  std::vector<float> rv;
-  rv.reserve(verticalSeparators.size());
-  for (int id : verticalSeparators)
-    rv.push_back(static_cast<float>(toDouble(id) + areaLeft_));
-  return rv;
+  return mergeSeparators(verticalSeparators, seps, minColumnWidth, areaLeft_);
 }
 
 std::vector<float> ProjectionProfile::findHorizontalSeparators(
     float minRowHeight, const std::vector<Ruling> &explicitRulings) const {
+  return findHorizontalSeparators(minRowHeight,
+                                  HorizontalRulingIndex(explicitRulings));
+}
+
+std::vector<float> ProjectionProfile::findHorizontalSeparators(
+    float minRowHeight, const HorizontalRulingIndex &explicitRulings) const {
   std::vector<int> horizontalSeparators;
-  for (const auto &r : explicitRulings) {
-    if (r.horizontal()) {
-      if (r.length() / areaWidth_ >= 0.95)
-        horizontalSeparators.push_back(toFixed(r.getPosition() - areaTop_));
-    }
+  for (const auto &r : explicitRulings.rulings()) {
+    if (r.length() / areaWidth_ >= 0.95)
+      horizontalSeparators.push_back(toFixed(r.getPosition() - areaTop_));
   }
 
   auto deriv = getFirstDeriv(horizontalProjection_);
   auto seps = findSeparatorsFromProjection(filter(deriv, 0.1f));
+  return mergeSeparators(horizontalSeparators, seps, minRowHeight, areaTop_);
+}
 
-  for (int foundSep : seps) {
-    bool foundShorter = false;
-    for (int explicitSep : horizontalSeparators) {
-      if (std::abs(toDouble(foundSep - explicitSep)) <= minRowHeight) {
-        foundShorter = true;
-        break;
-      }
-    }
-    if (!foundShorter)
-      horizontalSeparators.push_back(foundSep);
+// Adds each found separator unless one already kept (explicit or found
+// earlier) lies within minGap of it. `separators` must be sorted; it stays
+// sorted, so only the neighbours on either side need checking.
+std::vector<float>
+ProjectionProfile::mergeSeparators(std::vector<int> separators,
+                                   const std::vector<int> &found, float minGap,
+                                   double offset) const {
+  for (int foundSep : found) {
+    auto it = std::lower_bound(separators.begin(), separators.end(), foundSep);
+    bool tooClose =
+        (it != separators.end() &&
+         std::abs(toDouble(foundSep - *it)) <= minGap) ||
+        (it != separators.begin() &&
+         std::abs(toDouble(foundSep - *(it - 1))) <= minGap);
+    if (!tooClose)
+      separators.insert(it, foundSep);
   }
-  std::sort(horizontalSeparators.begin(), horizontalSeparators.end());
   std::vector<float> rv;
-  rv.reserve(horizontalSeparators.size());
-  for (int id : horizontalSeparators)
-    rv.push_back(static_cast<float>(toDouble(id) + areaTop_));
+  rv.reserve(separators.size());
+  for (int id : separators)
+    rv.push_back(static_cast<float>(toDouble(id) + offset));
   return rv;
 }
 
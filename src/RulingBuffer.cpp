@@ -0,0 +1,110 @@
+#include "tabula/RulingBuffer.h"
+#include "tabula/Utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace tabula {
+
+void RulingBuffer::assign(const std::vector<Ruling> &rulings) {
+  const size_t n = rulings.size();
+  x1.resize(n);
+  y1.resize(n);
+  x2.resize(n);
+  y2.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    x1[i] = static_cast<float>(rulings[i].getX1());
+    y1[i] = static_cast<float>(rulings[i].getY1());
+    x2[i] = static_cast<float>(rulings[i].getX2());
+    y2[i] = static_cast<float>(rulings[i].getY2());
+  }
+}
+
+void RulingBuffer::snap(float xThreshold, float yThreshold) {
+  const size_t n = size();
+  // endpoints interleaved as snapPoints sees them: x1, x2 of each ruling
+  xs.resize(2 * n);
+  ys.resize(2 * n);
+  for (size_t i = 0; i < n; ++i) {
+    xs[2 * i] = x1[i];
+    xs[2 * i + 1] = x2[i];
+    ys[2 * i] = y1[i];
+    ys[2 * i + 1] = y2[i];
+  }
+  Utils::snapValues(xs, xThreshold);
+  Utils::snapValues(ys, yThreshold);
+  for (size_t i = 0; i < n; ++i) {
+    x1[i] = xs[2 * i];
+    x2[i] = xs[2 * i + 1];
+    y1[i] = ys[2 * i];
+    y2[i] = ys[2 * i + 1];
+  }
+}
+
+template <RulingOrientation O>
+void RulingBuffer::collapseSide(std::vector<OrientedRuling<O>> &out,
+                                int expandAmount) {
+  out.clear();
+  const size_t n = position.size();
+  if (n == 0)
+    return;
+  // by start, then (stable) by position: (position, start) order
+  keys.resize(n);
+  order.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = Utils::floatKey(start[i]);
+    order[i] = static_cast<uint32_t>(i);
+  }
+  Utils::radixSortIndices(keys, order);
+  for (size_t i = 0; i < n; ++i)
+    keys[i] = Utils::floatKey(position[i]);
+  Utils::radixSortIndices(keys, order);
+
+  for (uint32_t i : order) {
+    if (!out.empty()) {
+      OrientedRuling<O> &last = out.back();
+      if (last.position == position[i] &&
+          last.start - expandAmount <= end[i] + expandAmount &&
+          start[i] - expandAmount <= last.end + expandAmount) {
+        last.start = std::min(last.start, start[i]);
+        last.end = std::max(last.end, end[i]);
+        continue;
+      }
+    }
+    if (end[i] == start[i])
+      continue;
+    out.push_back(OrientedRuling<O>(position[i], start[i], end[i]));
+  }
+}
+
+void RulingBuffer::collapse(std::vector<HorizontalRuling> &horizontal,
+                            std::vector<VerticalRuling> &vertical,
+                            int expandAmount) {
+  const size_t n = size();
+  // Ruling's orientation test: non-zero length and the two coordinates of
+  // the fixed axis within 0.01
+  position.clear();
+  start.clear();
+  end.clear();
+  for (size_t i = 0; i < n; ++i)
+    if (std::hypot(x2[i] - x1[i], y2[i] - y1[i]) > 0 &&
+        Utils::feq(y1[i], y2[i])) {
+      position.push_back(std::min(y1[i], y2[i]));
+      start.push_back(std::min(x1[i], x2[i]));
+      end.push_back(std::max(x1[i], x2[i]));
+    }
+  collapseSide(horizontal, expandAmount);
+
+  position.clear();
+  start.clear();
+  end.clear();
+  for (size_t i = 0; i < n; ++i)
+    if (std::hypot(x2[i] - x1[i], y2[i] - y1[i]) > 0 &&
+        Utils::feq(x1[i], x2[i])) {
+      position.push_back(std::min(x1[i], x2[i]));
+      start.push_back(std::min(y1[i], y2[i]));
+      end.push_back(std::max(y1[i], y2[i]));
+    }
+  collapseSide(vertical, expandAmount);
+}
+
+} // namespace tabula
@@ -0,0 +1,137 @@
+#include "tabula/RulingIntersections.h"
+#include <algorithm>
+#include <cmath>
+
+namespace tabula {
+
+const size_t RulingIntersections::npos;
+
+int32_t RulingIntersections::snap(double v) {
+  return static_cast<int32_t>(std::llround(v * 1000.0));
+}
+
+uint64_t RulingIntersections::hashKey(int32_t kx, int32_t ky) {
+  uint64_t k = (static_cast<uint64_t>(static_cast<uint32_t>(kx)) << 32) |
+               static_cast<uint32_t>(ky);
+  // 64-bit finalizer (splitmix64)
+  k ^= k >> 30;
+  k *= 0xbf58476d1ce4e5b9ULL;
+  k ^= k >> 27;
+  k *= 0x94d049bb133111ebULL;
+  k ^= k >> 31;
+  return k;
+}
+
+size_t RulingIntersections::findKey(int32_t kx, int32_t ky) const {
+  if (slots.empty())
+    return npos;
+  const size_t mask = slots.size() - 1;
+  for (size_t i = hashKey(kx, ky) & mask;; i = (i + 1) & mask) {
+    uint32_t s = slots[i];
+    if (s == 0)
+      return npos;
+    const Point &p = pts[s - 1];
+    if (p.kx == kx && p.ky == ky)
+      return s - 1;
+  }
+}
+
+void RulingIntersections::insert(const Point &p) {
+  const size_t mask = slots.size() - 1;
+  for (size_t i = hashKey(p.kx, p.ky) & mask;; i = (i + 1) & mask) {
+    uint32_t s = slots[i];
+    if (s == 0) {
+      pts.push_back(p);
+      slots[i] = static_cast<uint32_t>(pts.size());
+      return;
+    }
+    const Point &q = pts[s - 1];
+    if (q.kx == p.kx && q.ky == p.ky)
+      return; // first crossing at a point wins
+  }
+}
+
+RulingIntersections::RulingIntersections(
+    const std::vector<HorizontalRuling> &horizontal,
+    const std::vector<VerticalRuling> &vertical) {
+  build(horizontal, vertical);
+}
+
+RulingIntersections::RulingIntersections(const std::vector<Ruling> &horizontal,
+                                         const std::vector<Ruling> &vertical) {
+  std::vector<HorizontalRuling> hs;
+  std::vector<VerticalRuling> vs;
+  std::vector<uint32_t> hIndex, vIndex;
+  for (size_t i = 0; i < horizontal.size(); ++i)
+    if (horizontal[i].horizontal()) {
+      hs.emplace_back(horizontal[i]);
+      hIndex.push_back(static_cast<uint32_t>(i));
+    }
+  for (size_t i = 0; i < vertical.size(); ++i)
+    if (vertical[i].vertical()) {
+      vs.emplace_back(vertical[i]);
+      vIndex.push_back(static_cast<uint32_t>(i));
+    }
+  build(hs, vs);
+  // the table is keyed on position only, so indices can be remapped in place
+  for (Point &p : pts) {
+    p.h = hIndex[p.h];
+    p.v = vIndex[p.v];
+  }
+}
+
+void RulingIntersections::build(const std::vector<HorizontalRuling> &horizontal,
+                                const std::vector<VerticalRuling> &vertical) {
+  // Verticals sorted by x; stable so equal positions keep input order.
+  std::vector<uint32_t> byX(vertical.size());
+  for (size_t i = 0; i < vertical.size(); ++i)
+    byX[i] = static_cast<uint32_t>(i);
+  std::stable_sort(byX.begin(), byX.end(), [&](uint32_t a, uint32_t b) {
+    return vertical[a].position < vertical[b].position;
+  });
+  std::vector<double> xs;
+  xs.reserve(byX.size());
+  for (uint32_t i : byX)
+    xs.push_back(vertical[i].position);
+
+  // The table never holds more than one entry per H x V pair; size it for
+  // the common grid case and grow when it gets half full.
+  size_t capacity = 16;
+  while (capacity < 2 * std::min<size_t>(horizontal.size() * byX.size(),
+                                         4 * (horizontal.size() + byX.size())))
+    capacity <<= 1;
+  slots.assign(capacity, 0);
+
+  for (size_t hi = 0; hi < horizontal.size(); ++hi) {
+    const HorizontalRuling &h = horizontal[hi];
+    const double y = h.position;
+    auto first = std::lower_bound(xs.begin(), xs.end(), h.start - 2.0);
+    auto last = std::upper_bound(first, xs.end(), h.end + 2.0);
+    tested += static_cast<uint64_t>(last - first);
+    for (auto it = first; it != last; ++it) {
+      const uint32_t vi = byX[it - xs.begin()];
+      const VerticalRuling &v = vertical[vi];
+      if (y < v.start - 2.0 || y > v.end + 2.0)
+        continue;
+      if (2 * (pts.size() + 1) > slots.size()) {
+        // grow and rehash
+        slots.assign(slots.size() * 2, 0);
+        std::vector<Point> old;
+        old.swap(pts);
+        pts.reserve(old.size() + 1);
+        for (const Point &p : old)
+          insert(p);
+      }
+      Point p;
+      p.x = *it;
+      p.y = y;
+      p.kx = snap(p.x);
+      p.ky = snap(p.y);
+      p.h = static_cast<uint32_t>(hi);
+      p.v = vi;
+      insert(p);
+    }
+  }
+}
+
+} // namespace tabula
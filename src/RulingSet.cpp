@@ -0,0 +1,29 @@
+#include "tabula/RulingSet.h"
+#include "tabula/RulingBuffer.h"
+#include <utility>
+
+namespace tabula {
+
+RulingSet::RulingSet(const std::vector<Ruling> &rulings, float xThreshold,
+                     float yThreshold) {
+  if (rulings.empty())
+    return;
+  // one buffer per thread, reused page after page
+  static thread_local RulingBuffer buffer;
+  buffer.assign(rulings);
+  buffer.snap(xThreshold, yThreshold);
+  std::vector<HorizontalRuling> hs;
+  std::vector<VerticalRuling> vs;
+  buffer.collapse(hs, vs);
+  // already in (position, start) order
+  horizontal = HorizontalRulingIndex(std::move(hs));
+  vertical = VerticalRulingIndex(std::move(vs));
+
+  all.reserve(vertical.rulings().size() + horizontal.rulings().size());
+  for (const auto &r : vertical.rulings())
+    all.push_back(r.toRuling());
+  for (const auto &r : horizontal.rulings())
+    all.push_back(r.toRuling());
+}
+
+} // namespace tabula
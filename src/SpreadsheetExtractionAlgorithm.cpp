@@ -1,35 +1,228 @@
 #include "tabula/SpreadsheetExtractionAlgorithm.h"
 #include "tabula/Ruling.h"
+#include "tabula/RulingIntersections.h"
 #include "tabula/TableWithRulingLines.h"
 #include "tabula/TextElement.h"
 #include "tabula/Utils.h"
 #include "tabula/TextChunk.h"
+#include "tabula/TextLayout.h"
 #include "tabula/Diagnostics.h"
+#include "tabula/Metrics.h"
+#include "tabula/Trace.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
-#include <map>
-#include <set>
+#include <unordered_map>
 #include <utility>
 
 namespace tabula {
 
+namespace {
+
+// Grid graph over ruling crossings: every crossing links to the next one to
+// its right on the same y and the next one below it on the same x (positions
+// compared on the snapped keys).
+struct CrossingGraph {
+  static const uint32_t none = 0xffffffffu;
+  std::vector<uint32_t> order; // crossings sorted by (y, x)
+  std::vector<uint32_t> right;
+  std::vector<uint32_t> down;
+
+  explicit CrossingGraph(const RulingIntersections &ix) {
+    typedef RulingIntersections::Point Point;
+    const std::vector<Point> &pts = ix.points();
+    const size_t n = pts.size();
+    right.assign(n, none);
+    down.assign(n, none);
+    order.resize(n);
+    for (size_t i = 0; i < n; ++i)
+      order[i] = static_cast<uint32_t>(i);
+    std::vector<uint32_t> byColumn = order;
+
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+      return pts[a].ky != pts[b].ky ? pts[a].ky < pts[b].ky
+                                    : pts[a].kx < pts[b].kx;
+    });
+    for (size_t i = 0; i + 1 < n; ++i)
+      if (pts[order[i]].ky == pts[order[i + 1]].ky)
+        right[order[i]] = order[i + 1];
+
+    std::sort(byColumn.begin(), byColumn.end(), [&](uint32_t a, uint32_t b) {
+      return pts[a].kx != pts[b].kx ? pts[a].kx < pts[b].kx
+                                    : pts[a].ky < pts[b].ky;
+    });
+    for (size_t i = 0; i + 1 < n; ++i)
+      if (pts[byColumn[i]].kx == pts[byColumn[i + 1]].kx)
+        down[byColumn[i]] = byColumn[i + 1];
+  }
+};
+
+const uint32_t CrossingGraph::none;
+
+// Disjoint-set forest with path halving and union by size.
+struct UnionFind {
+  std::vector<uint32_t> parent, size;
+  explicit UnionFind(size_t n) : parent(n), size(n, 1) {
+    for (size_t i = 0; i < n; ++i)
+      parent[i] = static_cast<uint32_t>(i);
+  }
+  uint32_t find(uint32_t a) {
+    while (parent[a] != a)
+      a = parent[a] = parent[parent[a]];
+    return a;
+  }
+  void unite(uint32_t a, uint32_t b) {
+    a = find(a);
+    b = find(b);
+    if (a == b)
+      return;
+    if (size[a] < size[b])
+      std::swap(a, b);
+    parent[b] = a;
+    size[a] += size[b];
+  }
+};
+
+// Split cells into tables: two cells belong to the same table when edges of
+// theirs lying on the same line overlap or touch (shared walls and shared
+// corners). Edges are hashed by orientation and snapped line position and
+// each line's edges are swept in order. Groups hold cell indices in
+// ascending order and are ordered by their first cell.
+template <typename CellT>
+std::vector<std::vector<size_t>>
+connectedCellGroups(const std::vector<CellT> &cells) {
+  struct Edge {
+    int32_t start, end;
+    uint32_t cell;
+  };
+  typedef RulingIntersections R;
+  std::unordered_map<uint64_t, std::vector<Edge>> lines;
+  auto addEdge = [&](uint32_t orientation, float pos, float a, float b,
+                     size_t cell) {
+    uint64_t key = (static_cast<uint64_t>(orientation) << 32) |
+                   static_cast<uint32_t>(R::snap(pos));
+    lines[key].push_back(
+        Edge{R::snap(a), R::snap(b), static_cast<uint32_t>(cell)});
+  };
+  for (size_t i = 0; i < cells.size(); ++i) {
+    const CellT &c = cells[i];
+    addEdge(0, c.getLeft(), c.getTop(), c.getBottom(), i);
+    addEdge(0, c.getRight(), c.getTop(), c.getBottom(), i);
+    addEdge(1, c.getTop(), c.getLeft(), c.getRight(), i);
+    addEdge(1, c.getBottom(), c.getLeft(), c.getRight(), i);
+  }
+
+  UnionFind uf(cells.size());
+  for (auto &kv : lines) {
+    std::vector<Edge> &edges = kv.second;
+    std::sort(edges.begin(), edges.end(),
+              [](const Edge &a, const Edge &b) { return a.start < b.start; });
+    int32_t runEnd = edges.front().end;
+    uint32_t runCell = edges.front().cell;
+    for (size_t k = 1; k < edges.size(); ++k) {
+      if (edges[k].start <= runEnd) {
+        uf.unite(runCell, edges[k].cell);
+        runEnd = std::max(runEnd, edges[k].end);
+      } else {
+        runEnd = edges[k].end;
+        runCell = edges[k].cell;
+      }
+    }
+  }
+
+  std::vector<std::vector<size_t>> groups;
+  std::unordered_map<uint32_t, size_t> groupOfRoot;
+  for (size_t i = 0; i < cells.size(); ++i) {
+    uint32_t root = uf.find(static_cast<uint32_t>(i));
+    auto it = groupOfRoot.find(root);
+    if (it == groupOfRoot.end()) {
+      it = groupOfRoot.insert(std::make_pair(root, groups.size())).first;
+      groups.emplace_back();
+    }
+    groups[it->second].push_back(i);
+  }
+  return groups;
+}
+
+template <typename CellT>
+Rectangle boundingBoxOf(const std::vector<CellT> &cells,
+                        const std::vector<size_t> &group) {
+  float top = cells[group.front()].getTop();
+  float left = cells[group.front()].getLeft();
+  float bottom = cells[group.front()].getBottom();
+  float right = cells[group.front()].getRight();
+  for (size_t i : group) {
+    top = std::min(top, cells[i].getTop());
+    left = std::min(left, cells[i].getLeft());
+    bottom = std::max(bottom, cells[i].getBottom());
+    right = std::max(right, cells[i].getRight());
+  }
+  return Rectangle(top, left, right - left, bottom - top);
+}
+
+// Shared body of both findCells overloads.
+std::vector<Cell> cellsFromCrossings(const RulingIntersections &intersections) {
+  if (Metrics::enabled())
+    Metrics::add(Metrics::IntersectionsTested, intersections.pairsTested());
+  std::vector<Cell> cellsFound;
+  CrossingGraph graph(intersections);
+  const std::vector<RulingIntersections::Point> &crossings =
+      intersections.points();
+
+  // Walk the crossings top-to-bottom, left-to-right. For each top-left
+  // corner, the cell closes at the first crossing below it (along its x)
+  // for which some crossing to its right (along its y) has a matching
+  // bottom-right corner. On a regular grid that is the immediate neighbours;
+  // merged rows/columns just follow the chains a few steps further.
+  for (uint32_t tl : graph.order) {
+    bool found = false;
+    for (uint32_t d = graph.down[tl]; d != CrossingGraph::none && !found;
+         d = graph.down[d]) {
+      for (uint32_t r = graph.right[tl]; r != CrossingGraph::none;
+           r = graph.right[r]) {
+        size_t br = intersections.findKey(crossings[r].kx, crossings[d].ky);
+        if (br == RulingIntersections::npos)
+          continue;
+        const RulingIntersections::Point &topLeft = crossings[tl];
+        const RulingIntersections::Point &btmRight = crossings[br];
+        double top = topLeft.y;
+        double left = topLeft.x;
+        double right = btmRight.x;
+        double bottom = btmRight.y;
+        cellsFound.emplace_back(static_cast<float>(top),
+                                static_cast<float>(left),
+                                static_cast<float>(right - left),
+                                static_cast<float>(bottom - top));
+        found = true;
+        break;
+      }
+    }
+  }
+
+  return cellsFound;
+}
+
+} // namespace
+
 std::vector<Table>
 SpreadsheetExtractionAlgorithm::extract(const Page &page) const {
-  std::vector<Ruling> horizontals;
-  std::vector<Ruling> verticals;
-  for (auto const &r : page.getRulings()) {
-    if (r.horizontal())
-      horizontals.push_back(r);
-    else if (r.vertical())
-      verticals.push_back(r);
-  }
-  horizontals = Ruling::collapseOrientedRulings(horizontals);
-  verticals = Ruling::collapseOrientedRulings(verticals);
+  TABULA_TRACE_SCOPE("spreadsheet.extract", page.getPageNumber());
+  // the page's cleaned rulings are already split, collapsed and sorted
+  const std::shared_ptr<const RulingSet> rulings = page.getRulingSet();
+  const std::vector<HorizontalRuling> &horizontals =
+      rulings->getHorizontalRulings();
+  const std::vector<VerticalRuling> &verticals = rulings->getVerticalRulings();
 
   auto cells = findCells(horizontals, verticals);
+  if (Metrics::enabled()) {
+    Metrics::add(Metrics::RulingsBeforeCollapse,
+                 page.getUnprocessedRulings().size());
+    Metrics::add(Metrics::RulingsAfterCollapse,
+                 horizontals.size() + verticals.size());
+    Metrics::add(Metrics::CellsFound, cells.size());
+  }
   // Diagnostic: print number of detected cells and sample coordinates
-  try {
+  if (tabula::diagnosticsEnabled()) try {
     tabula::diag(std::string("[diag] detected cells=") + std::to_string(cells.size()));
     size_t maxc = 20;
     for (size_t ci = 0; ci < cells.size() && ci < maxc; ++ci) {
@@ -37,56 +230,57 @@ SpreadsheetExtractionAlgorithm::extract(const Page &page) const {
       tabula::diag(std::string("[diag] CELL idx=") + std::to_string(ci) + " top=" + std::to_string(cc.getTop()) + " left=" + std::to_string(cc.getLeft()) + " w=" + std::to_string(cc.getWidth()) + " h=" + std::to_string(cc.getHeight()));
     }
   } catch (...) {}
-  // compute collapsed vertical rulings for per-cell merge
-  std::vector<Ruling> vertRulings = Ruling::collapseOrientedRulings(verticals);
-  auto areas = findSpreadsheetsFromCells(
-      std::vector<Rectangle>(cells.begin(), cells.end()));
+  // vertical rulings by x, for splitting words in the per-cell merge
+  const VerticalRulingIndex &vertRulings = rulings->getVerticalIndex();
+  const TextLayout &layout = page.getTextLayout();
+  TextLayout::Grouping grouping; // reused from cell to cell
+  // Every cell's words go into one store shared by the tables built here;
+  // cells keep a range of it.
+  std::shared_ptr<TextStore> words = std::make_shared<TextStore>();
 
+  // One table per group of connected cells; each table only looks at its
+  // own cells and at the rulings inside its area.
   std::vector<Table> tables;
-  for (auto const &area : areas) {
+  for (auto const &group : connectedCellGroups(cells)) {
+    const Rectangle area = boundingBoxOf(cells, group);
     std::vector<Cell> overlapping;
-    for (auto &c : cells) {
-      if (c.horizontalOverlap(area) > 0.0f || c.verticalOverlap(area) > 0.0f ||
-          c.overlapRatio(area) > 0.0f) {
-        // Collect raw TextElements inside this cell and merge them into
+    overlapping.reserve(group.size());
+    {
+      TABULA_TRACE_SCOPE("spreadsheet.cellText", page.getPageNumber());
+      for (size_t ci : group) {
+        Cell &c = cells[ci];
+        // Select the TextElements inside this cell and merge them into
         // word-level TextChunks (mirror Java's per-cell merge)
-        std::vector<TextElement> elems;
-        for (auto const &tc : page.getTextChunks()) {
-          for (auto const &te : tc.getTextElements()) {
-            if (te.overlapRatio(c) > 0.0f || c.overlapRatio(te) > 0.0f)
-              elems.push_back(te);
-          }
-        }
+        std::vector<uint32_t> elems = page.getTextElementIdsOverlapping(c);
         if (!elems.empty()) {
           // diagnostic: report raw element count and a sample
-          try {
-            std::string samp = elems.front().getText();
+          if (tabula::diagnosticsEnabled()) try {
+            std::string samp = layout.store().text(elems.front());
             if (samp.size() > 80)
               samp = samp.substr(0, 80) + "...";
             tabula::diag(std::string("[diag] cell_raw_elems top=") + std::to_string(c.getTop()) + " left=" + std::to_string(c.getLeft()) + " count=" + std::to_string(elems.size()) + " sample=\"" + samp + "\"");
           } catch (...) {}
-          auto merged = TextChunk::mergeWords(elems, &vertRulings);
-          std::vector<TextChunk> tcs = merged;
-          c.setTextElements(tcs);
+          layout.group(elems, &vertRulings, grouping);
+          c.setText(words, layout.appendWords(grouping, *words));
         } else {
-          tabula::diag(std::string("[diag] cell_raw_elems top=") + std::to_string(c.getTop()) + " left=" + std::to_string(c.getLeft()) + " count=0");
+          TABULA_DIAG(std::string("[diag] cell_raw_elems top=") + std::to_string(c.getTop()) + " left=" + std::to_string(c.getLeft()) + " count=0");
         }
-        overlapping.push_back(c);
+        overlapping.push_back(std::move(c));
       }
     }
 
     // crop rulings that intersect this area so the table constructor uses
     // only local segments
     std::vector<Ruling> horizCrop =
-        Ruling::cropRulingsToArea(horizontals, area);
-    std::vector<Ruling> vertCrop = Ruling::cropRulingsToArea(verticals, area);
+        rulings->getHorizontalIndex().cropToArea(area);
+    std::vector<Ruling> vertCrop = vertRulings.cropToArea(area);
 
-    // page number not currently stored on Page; pass 0 as placeholder
-    TableWithRulingLines tw(area, overlapping, horizCrop, vertCrop,
+    TABULA_TRACE_SCOPE("spreadsheet.buildTable", page.getPageNumber());
+    TableWithRulingLines tw(area, std::move(overlapping), horizCrop, vertCrop,
                             page.getPageNumber());
     // slice into Table vector (TableWithRulingLines populates base Table
     // fields)
-    tables.push_back(tw);
+    tables.push_back(std::move(tw));
   }
   return tables;
 }
@@ -94,135 +288,26 @@ SpreadsheetExtractionAlgorithm::extract(const Page &page) const {
 std::vector<Cell>
 SpreadsheetExtractionAlgorithm::findCells(const std::vector<Ruling> &horizontal,
                                           const std::vector<Ruling> &vertical) {
-  std::vector<Cell> cellsFound;
-  // Build intersection map similar to Java implementation
-  std::map<std::pair<double, double>, std::pair<Ruling, Ruling>> intersections;
-  for (std::vector<Ruling>::const_iterator ih = horizontal.begin();
-       ih != horizontal.end(); ++ih) {
-    const Ruling &h = *ih;
-    for (std::vector<Ruling>::const_iterator iv = vertical.begin();
-         iv != vertical.end(); ++iv) {
-      const Ruling &v = *iv;
-      auto p = h.intersectionPoint(v);
-      if (!std::isnan(p.first) && !std::isnan(p.second)) {
-        intersections.emplace(std::make_pair(p.first, p.second),
-                              std::make_pair(h.expand(2.0), v.expand(2.0)));
-      }
-    }
-  }
-
-  // Convert keys to vector and sort Y-first
-  std::vector<std::pair<double, double>> points;
-  for (std::map<std::pair<double, double>,
-                std::pair<Ruling, Ruling>>::const_iterator it =
-           intersections.begin();
-       it != intersections.end(); ++it)
-    points.push_back(it->first);
-  std::sort(points.begin(), points.end(),
-            [](const std::pair<double, double> &a,
-               const std::pair<double, double> &b) {
-              if (a.second != b.second)
-                return a.second < b.second;
-              return a.first < b.first;
-            });
-
-  for (size_t i = 0; i < points.size(); ++i) {
-    auto topLeft = points[i];
-    std::map<std::pair<double, double>,
-             std::pair<Ruling, Ruling>>::const_iterator hv_it =
-        intersections.find(topLeft);
-    if (hv_it == intersections.end())
-      continue;
-    const std::pair<Ruling, Ruling> &hv = hv_it->second;
-
-    std::vector<std::pair<double, double>> xPoints, yPoints;
-    for (size_t j = i; j < points.size(); ++j) {
-      auto p = points[j];
-      if (p.first == topLeft.first && p.second > topLeft.second)
-        xPoints.push_back(p);
-      if (p.second == topLeft.second && p.first > topLeft.first)
-        yPoints.push_back(p);
-    }
-
-    bool outer_break = false;
-    for (auto const &xp : xPoints) {
-      // vertical edge check - compare vertical position
-      std::map<std::pair<double, double>,
-               std::pair<Ruling, Ruling>>::const_iterator xp_it =
-          intersections.find(xp);
-      if (xp_it == intersections.end())
-        continue;
-      if (!Utils::feq(xp_it->second.second.getLeft(), hv.second.getLeft()))
-        continue;
-      for (auto const &yp : yPoints) {
-        std::map<std::pair<double, double>,
-                 std::pair<Ruling, Ruling>>::const_iterator yp_it =
-            intersections.find(yp);
-        if (yp_it == intersections.end())
-          continue;
-        if (!Utils::feq(yp_it->second.first.getTop(), hv.first.getTop()))
-          continue;
-        std::pair<double, double> btmRight = {yp.first, xp.second};
-        std::map<std::pair<double, double>,
-                 std::pair<Ruling, Ruling>>::const_iterator br_it =
-            intersections.find(btmRight);
-        if (br_it != intersections.end()) {
-          const std::pair<Ruling, Ruling> &br = br_it->second;
-          std::map<std::pair<double, double>,
-                   std::pair<Ruling, Ruling>>::const_iterator xp_it2 =
-              intersections.find(xp);
-          std::map<std::pair<double, double>,
-                   std::pair<Ruling, Ruling>>::const_iterator yp_it2 =
-              intersections.find(yp);
-          if (xp_it2 == intersections.end() || yp_it2 == intersections.end())
-            continue;
-          if (Utils::feq(br.first.getTop(), xp_it2->second.first.getTop()) &&
-              Utils::feq(br.second.getLeft(),
-                         yp_it2->second.second.getLeft())) {
-            double top = topLeft.second;
-            double left = topLeft.first;
-            double right = btmRight.first;
-            double bottom = btmRight.second;
-            cellsFound.emplace_back(static_cast<float>(top),
-                                    static_cast<float>(left),
-                                    static_cast<float>(right - left),
-                                    static_cast<float>(bottom - top));
-            outer_break = true;
-            break;
-          }
-        }
-      }
-      if (outer_break)
-        break;
-    }
-  }
+  TABULA_TRACE_SCOPE("spreadsheet.findCells");
+  // Crossings of every horizontal with the verticals inside its span
+  RulingIntersections intersections(horizontal, vertical);
+  return cellsFromCrossings(intersections);
+}
 
-  return cellsFound;
+std::vector<Cell> SpreadsheetExtractionAlgorithm::findCells(
+    const std::vector<HorizontalRuling> &horizontal,
+    const std::vector<VerticalRuling> &vertical) {
+  TABULA_TRACE_SCOPE("spreadsheet.findCells");
+  RulingIntersections intersections(horizontal, vertical);
+  return cellsFromCrossings(intersections);
 }
 
 std::vector<Rectangle>
 SpreadsheetExtractionAlgorithm::findSpreadsheetsFromCells(
     const std::vector<Rectangle> &cells) {
-  // Reuse Java approach: symmetric difference of vertices to form polygons
   std::vector<Rectangle> rectangles;
-  std::set<std::pair<double, double>> pointSet;
-  for (auto const &cell : cells) {
-    for (auto const &pt : cell.getPoints())
-      pointSet.insert({pt.first, pt.second});
-  }
-  // Simplified: return bounding box of all points as single rectangle if any
-  if (pointSet.empty())
-    return rectangles;
-  double top = 1e9, left = 1e9, bottom = -1e9, right = -1e9;
-  for (auto const &p : pointSet) {
-    left = std::min(left, p.first);
-    right = std::max(right, p.first);
-    top = std::min(top, p.second);
-    bottom = std::max(bottom, p.second);
-  }
-  rectangles.emplace_back(static_cast<float>(top), static_cast<float>(left),
-                          static_cast<float>(right - left),
-                          static_cast<float>(bottom - top));
+  for (auto const &group : connectedCellGroups(cells))
+    rectangles.push_back(boundingBoxOf(cells, group));
   return rectangles;
 }
 
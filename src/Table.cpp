@@ -0,0 +1,142 @@
+#include "tabula/Table.h"
+#include <algorithm>
+
+namespace tabula {
+
+namespace {
+// A grid this small stays dense however empty it is; past it, the table
+// switches to the map once fewer than 1 in 8 slots would hold a cell.
+const size_t denseMinSlots = 1 << 16;
+const size_t maxSlotsPerCell = 8;
+} // namespace
+
+void Table::add(Cell &&cell, int row, int col) {
+  bool fresh = false;
+  Cell *s = slot(row, col, fresh);
+  if (!s)
+    return;
+  if (fresh)
+    *s = std::move(cell);
+  else // merge geometries and text elements into existing cell
+    s->mergeInPlace(cell);
+}
+
+void Table::addPlaceholder(const Rectangle &bounds, int row, int col) {
+  bool fresh = false;
+  Cell *s = slot(row, col, fresh);
+  if (!s)
+    return;
+  if (fresh) {
+    // the slot holds a default Cell; give it the covered area
+    static_cast<Rectangle &>(*s) = bounds;
+    s->setPlaceholder(true);
+  } else {
+    // an empty cell merged in only grows the bounds
+    s->Rectangle::merge(bounds);
+  }
+}
+
+Cell *Table::slot(int row, int col, bool &fresh) {
+  if (row < 0 || col < 0)
+    return nullptr;
+  const int newRows = std::max(rowCount, row + 1);
+  const int newStride = col < stride ? stride : std::max(col + 1, 2 * stride);
+  if (!sparse) {
+    const size_t slots = static_cast<size_t>(newRows) * newStride;
+    if (slots > denseMinSlots && slots > maxSlotsPerCell * (filledCount + 1))
+      toSparse();
+  }
+  rowCount = newRows;
+  colCount = std::max(colCount, col + 1);
+  memoizedRows.clear();
+  sparseGrid.clear();
+  sparseGridBuilt = false;
+
+  if (sparse) {
+    auto ins = sparseCells.emplace(std::make_pair(row, col), Cell());
+    fresh = ins.second;
+    return &ins.first->second;
+  }
+
+  if (newStride != stride)
+    restride(newStride);
+  const size_t need = static_cast<size_t>(rowCount) * stride;
+  if (cells.size() < need) {
+    cells.resize(need);
+    filled.resize(need, 0);
+  }
+  const size_t i = static_cast<size_t>(row) * stride + col;
+  fresh = !filled[i];
+  if (fresh) {
+    filled[i] = 1;
+    ++filledCount;
+  }
+  return &cells[i];
+}
+
+void Table::restride(int newStride) {
+  const size_t rows = stride > 0 ? cells.size() / stride : 0;
+  std::vector<Cell> grid(rows * newStride);
+  std::vector<uint8_t> mask(grid.size(), 0);
+  for (size_t r = 0; r < rows; ++r)
+    for (int c = 0; c < stride; ++c) {
+      const size_t from = r * stride + c;
+      if (!filled[from])
+        continue;
+      grid[r * newStride + c] = std::move(cells[from]);
+      mask[r * newStride + c] = 1;
+    }
+  cells.swap(grid);
+  filled.swap(mask);
+  stride = newStride;
+}
+
+void Table::toSparse() {
+  for (size_t i = 0; i < cells.size(); ++i)
+    if (filled[i])
+      sparseCells.emplace(std::make_pair(static_cast<int>(i / stride),
+                                         static_cast<int>(i % stride)),
+                          std::move(cells[i]));
+  std::vector<Cell>().swap(cells);
+  std::vector<uint8_t>().swap(filled);
+  stride = 0;
+  sparse = true;
+}
+
+Table::RowView Table::getRow(int row) const {
+  if (row < 0 || row >= rowCount)
+    return RowView();
+  if (!sparse)
+    return RowView(cells.data() + static_cast<size_t>(row) * stride,
+                   static_cast<size_t>(colCount));
+  if (!sparseGridBuilt) {
+    sparseGrid.assign(static_cast<size_t>(rowCount) * colCount, Cell());
+    for (auto const &p : sparseCells)
+      sparseGrid[static_cast<size_t>(p.first.first) * colCount +
+                 p.first.second] = p.second;
+    sparseGridBuilt = true;
+  }
+  return RowView(sparseGrid.data() + static_cast<size_t>(row) * colCount,
+                 static_cast<size_t>(colCount));
+}
+
+bool Table::hasCell(int row, int col) const {
+  if (row < 0 || col < 0 || row >= rowCount || col >= colCount)
+    return false;
+  if (sparse)
+    return sparseCells.count(std::make_pair(row, col)) != 0;
+  return filled[static_cast<size_t>(row) * stride + col] != 0;
+}
+
+void Table::computeRows() const {
+  memoizedRows.assign(rowCount, std::vector<Cell>());
+  for (int r = 0; r < rowCount; ++r) {
+    RowView row = getRow(r);
+    // assemble each cell's text once, so the copies carry it too
+    for (auto const &cell : row)
+      cell.text();
+    memoizedRows[r].assign(row.begin(), row.end());
+  }
+}
+
+} // namespace tabula
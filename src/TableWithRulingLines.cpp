@@ -1,4 +1,219 @@
 #include "tabula/TableWithRulingLines.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <utility>
 
-// implementation inline in header for simplicity; this file kept to register
-// with build
+namespace tabula {
+
+namespace {
+
+bool feq(float a, float b) { return std::abs(a - b) < 1e-6f; }
+
+// Sorted, de-duplicated grid lines: the area's two edges plus each ruling's
+// coordinate.
+std::vector<double> gridLines(float first, float last,
+                              const std::vector<Ruling> &rulings,
+                              bool horizontal) {
+  std::vector<double> lines;
+  lines.reserve(rulings.size() + 2);
+  lines.push_back(static_cast<double>(first));
+  for (auto const &r : rulings) {
+    if (horizontal && r.horizontal())
+      lines.push_back(r.getTop());
+    else if (!horizontal && r.vertical())
+      lines.push_back(r.getLeft());
+  }
+  lines.push_back(static_cast<double>(last));
+  std::sort(lines.begin(), lines.end());
+  lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+  return lines;
+}
+
+// First grid slot covered by [lo, hi] and how many slots it covers.
+void slotRange(const std::vector<double> &lines, double lo, double hi,
+               int &first, int &span) {
+  first = std::max(
+      0, static_cast<int>(std::upper_bound(lines.begin(), lines.end(), lo) -
+                          lines.begin()) -
+             1);
+  const int last = std::max(
+      0, static_cast<int>(std::lower_bound(lines.begin(), lines.end(), hi) -
+                          lines.begin()) -
+             1);
+  span = std::max(1, last - first + 1);
+}
+
+// Running maximum over points: raise all points of [l, r) to at least v,
+// then read one point back.
+class MaxTree {
+public:
+  explicit MaxTree(size_t n) : n(n), tag(2 * n, 0) {}
+  void raise(size_t l, size_t r, int v) {
+    for (l += n, r += n; l < r; l >>= 1, r >>= 1) {
+      if (l & 1)
+        tag[l] = std::max(tag[l], v), ++l;
+      if (r & 1)
+        --r, tag[r] = std::max(tag[r], v);
+    }
+  }
+  int at(size_t i) const {
+    int best = 0;
+    for (i += n; i > 0; i >>= 1)
+      best = std::max(best, tag[i]);
+    return best;
+  }
+
+private:
+  size_t n;
+  std::vector<int> tag;
+};
+
+} // namespace
+
+TableWithRulingLines::TableWithRulingLines(
+    const Rectangle &area, std::vector<Cell> &&cells,
+    const std::vector<Ruling> &horizontalRulings,
+    const std::vector<Ruling> &verticalRulings, int pageNumber)
+    : verticalRulings(verticalRulings), horizontalRulings(horizontalRulings) {
+  this->setRect(area);
+  this->setPageNumber(pageNumber);
+  if (cells.empty())
+    return;
+  // Without any rulings fall back to Java's addCells, which preserves
+  // behavior for PDFs without ruling lines.
+  if (verticalRulings.empty() && horizontalRulings.empty())
+    addCellsByPosition(cells);
+  else
+    addCellsByRulings(area, cells);
+}
+
+void TableWithRulingLines::addCellsByRulings(const Rectangle &area,
+                                             std::vector<Cell> &cells) {
+  const std::vector<double> xs =
+      gridLines(area.getLeft(), area.getRight(), verticalRulings, false);
+  const std::vector<double> ys =
+      gridLines(area.getTop(), area.getBottom(), horizontalRulings, true);
+
+  for (auto &c : cells) {
+    int startCol, colspan, startRow, rowspan;
+    slotRange(xs, c.getLeft(), c.getRight(), startCol, colspan);
+    slotRange(ys, c.getTop(), c.getBottom(), startRow, rowspan);
+    c.setSpan(rowspan, colspan);
+
+    // the anchor goes to its top-left slot; the other covered slots become
+    // placeholders with the anchor's top and height and their column's width
+    const float phTop = c.getTop(), phHeight = c.getHeight();
+    this->add(std::move(c), startRow, startCol);
+    for (int kr = 0; kr < rowspan; ++kr)
+      for (int kc = 0; kc < colspan; ++kc) {
+        if (kr == 0 && kc == 0)
+          continue;
+        const size_t col = static_cast<size_t>(startCol + kc);
+        const double lx = xs[col];
+        const double rx = col + 1 < xs.size() ? xs[col + 1] : xs.back();
+        this->addPlaceholder(Rectangle(phTop, static_cast<float>(lx),
+                                       static_cast<float>(rx - lx), phHeight),
+                             startRow + kr, startCol + kc);
+      }
+  }
+}
+
+void TableWithRulingLines::addCellsByPosition(std::vector<Cell> &cells) {
+  // rows: cells ordered by (top, left), a new row wherever the top changes
+  std::vector<uint32_t> order(cells.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    if (cells[a].getTop() != cells[b].getTop())
+      return cells[a].getTop() < cells[b].getTop();
+    return cells[a].getLeft() < cells[b].getLeft();
+  });
+  std::vector<size_t> rowStart(1, 0);
+  for (size_t p = 1; p < order.size(); ++p)
+    if (!feq(cells[order[p]].getTop(), cells[order[p - 1]].getTop()))
+      rowStart.push_back(p);
+  const size_t rowCount = rowStart.size();
+  rowStart.push_back(order.size());
+
+  // A row starts after the widest row of cells lying wholly below and to
+  // the left of its first cell: those at or below its bottom (a suffix of
+  // `order`) whose right edge is at or before its left. Sweep the rows'
+  // bottoms upwards, adding rows to a tree that keeps, per right-edge
+  // threshold, the most cells any added row has up to it.
+  std::vector<float> rights;
+  rights.reserve(cells.size());
+  for (auto const &c : cells)
+    rights.push_back(c.getRight());
+  std::sort(rights.begin(), rights.end());
+  rights.erase(std::unique(rights.begin(), rights.end()), rights.end());
+  auto rank = [&](float r) {
+    return static_cast<size_t>(
+        std::lower_bound(rights.begin(), rights.end(), r) - rights.begin());
+  };
+
+  std::vector<size_t> below(rowCount); // first position at or below the row
+  for (size_t i = 0; i < rowCount; ++i) {
+    const float bottom = cells[order[rowStart[i]]].getBottom();
+    below[i] = static_cast<size_t>(
+        std::partition_point(order.begin(), order.end(),
+                             [&](uint32_t id) {
+                               return cells[id].getTop() < bottom;
+                             }) -
+        order.begin());
+  }
+  std::vector<size_t> byBelow(rowCount);
+  std::iota(byBelow.begin(), byBelow.end(), size_t(0));
+  std::sort(byBelow.begin(), byBelow.end(),
+            [&](size_t a, size_t b) { return below[a] > below[b]; });
+
+  MaxTree widest(rights.size());
+  std::vector<float> rowRights;
+  std::vector<int> startColumn(rowCount, 0);
+  size_t added = rowCount; // rows [added, rowCount) are in the tree
+  for (size_t i : byBelow) {
+    const size_t p = below[i];
+    const float left = cells[order[rowStart[i]]].getLeft();
+    // the row holding p; only its cells from p on lie below
+    const size_t j = static_cast<size_t>(
+        std::upper_bound(rowStart.begin(), rowStart.begin() + rowCount, p) -
+        rowStart.begin() - 1);
+    const size_t whole = p < order.size() && p == rowStart[j] ? j : j + 1;
+    while (added > whole) {
+      --added;
+      rowRights.clear();
+      for (size_t q = rowStart[added]; q < rowStart[added + 1]; ++q)
+        rowRights.push_back(cells[order[q]].getRight());
+      std::sort(rowRights.begin(), rowRights.end());
+      // k cells end at or before any threshold in [rowRights[k-1], next)
+      for (size_t k = 1; k <= rowRights.size(); ++k) {
+        const size_t from = rank(rowRights[k - 1]);
+        const size_t to =
+            k < rowRights.size() ? rank(rowRights[k]) : rights.size();
+        if (from < to)
+          widest.raise(from, to, static_cast<int>(k));
+      }
+    }
+    int best = 0;
+    const size_t upTo = static_cast<size_t>(
+        std::upper_bound(rights.begin(), rights.end(), left) - rights.begin());
+    if (upTo > 0)
+      best = widest.at(upTo - 1);
+    if (whole != j) {
+      int partial = 0;
+      for (size_t q = p; q < rowStart[j + 1]; ++q)
+        if (cells[order[q]].getRight() <= left)
+          ++partial;
+      best = std::max(best, partial);
+    }
+    startColumn[i] = best;
+  }
+
+  for (size_t i = 0; i < rowCount; ++i) {
+    int col = startColumn[i];
+    for (size_t p = rowStart[i]; p < rowStart[i + 1]; ++p)
+      this->add(std::move(cells[order[p]]), static_cast<int>(i), col++);
+  }
+}
+
+} // namespace tabula
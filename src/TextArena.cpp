@@ -0,0 +1,66 @@
+#include "tabula/TextArena.h"
+#include <algorithm>
+#include <cstring>
+
+namespace tabula {
+
+TextArena::TextArena(size_t blockSize_)
+    : blockSize(std::max<size_t>(blockSize_, 64)) {}
+
+char *TextArena::reserve(size_t n) {
+  if (static_cast<size_t>(last - cur) >= n)
+    return cur;
+  // a string being built moves along to the new block
+  const size_t keep = building ? static_cast<size_t>(cur - pending) : 0;
+  const size_t size = std::max(blockSize, keep + n);
+  std::unique_ptr<char[]> block(new char[size]);
+  char *start = block.get();
+  blocks.push_back(std::move(block));
+  if (keep)
+    std::memcpy(start, pending, keep);
+  if (building)
+    pending = start;
+  cur = start + keep;
+  last = start + size;
+  return cur;
+}
+
+TextView TextArena::append(const char *s, size_t n) {
+  if (n == 0)
+    return TextView("", 0);
+  char *p = reserve(n);
+  std::memcpy(p, s, n);
+  cur += n;
+  used += n;
+  return TextView(p, n);
+}
+
+void TextArena::appendPart(const char *s, size_t n) {
+  if (!building) {
+    building = true;
+    pending = cur;
+  }
+  if (n == 0)
+    return;
+  char *p = reserve(n);
+  std::memcpy(p, s, n);
+  cur += n;
+}
+
+TextView TextArena::finish() {
+  const size_t n = building ? static_cast<size_t>(cur - pending) : 0;
+  building = false;
+  if (n == 0)
+    return TextView("", 0);
+  used += n;
+  return TextView(pending, n);
+}
+
+void TextArena::clear() {
+  blocks.clear();
+  cur = last = pending = nullptr;
+  building = false;
+  used = 0;
+}
+
+} // namespace tabula
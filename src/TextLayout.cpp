@@ -0,0 +1,148 @@
+#include "tabula/TextLayout.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace tabula {
+
+TextLayout::TextLayout(std::shared_ptr<const TextStore> store)
+    : textStore(std::move(store)) {
+  layout();
+}
+
+TextLayout::TextLayout(const std::vector<TextElement> &els) {
+  size_t bytes = 0;
+  for (const auto &te : els)
+    bytes += te.getTextView().size();
+  std::shared_ptr<TextStore> store = std::make_shared<TextStore>();
+  store->reserve(els.size(), bytes);
+  for (const auto &te : els)
+    store->add(te);
+  textStore = std::move(store);
+  layout();
+}
+
+void TextLayout::layout() {
+  const size_t n = textStore->size();
+  top.resize(n);
+  left.resize(n);
+  right.resize(n);
+  bottom.resize(n);
+  height.resize(n);
+  centerY.resize(n);
+  space.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    const TextStore::Box &b = textStore->box(static_cast<uint32_t>(i));
+    top[i] = b.top;
+    left[i] = b.left;
+    right[i] = b.left + b.width;
+    bottom[i] = b.top + b.height;
+    height[i] = b.height;
+    centerY[i] = b.top + b.height * 0.5f;
+    space[i] = textStore->info(static_cast<uint32_t>(i)).widthOfSpace;
+  }
+}
+
+void TextLayout::group(const std::vector<uint32_t> &ids,
+                       const VerticalRulingIndex *verticalRulings,
+                       Grouping &out) const {
+  out.ids = ids;
+  out.lines.clear();
+  out.words.clear();
+  if (ids.empty())
+    return;
+
+  // Line clustering threshold from the average element height, summed in
+  // page order.
+  float avgHeight = 0.0f;
+  for (uint32_t id : ids)
+    avgHeight += height[id];
+  avgHeight /= static_cast<float>(ids.size());
+  const float lineThreshold = std::max(1.0f, avgHeight * 0.6f);
+
+  std::vector<uint32_t> &order = out.ids;
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    if (centerY[a] != centerY[b])
+      return centerY[a] < centerY[b];
+    return left[a] < left[b];
+  });
+
+  // Each line is compared against its first element's center.
+  uint32_t lineStart = 0;
+  for (uint32_t i = 1; i <= order.size(); ++i) {
+    if (i < order.size() &&
+        std::abs(centerY[order[i]] - centerY[order[lineStart]]) <=
+            lineThreshold)
+      continue;
+    out.lines.push_back(Range{lineStart, i});
+    lineStart = i;
+  }
+
+  for (const Range &line : out.lines) {
+    std::sort(order.begin() + line.begin, order.begin() + line.end,
+              [&](uint32_t a, uint32_t b) { return left[a] < left[b]; });
+    uint32_t wordStart = line.begin;
+    for (uint32_t i = line.begin + 1; i < line.end; ++i) {
+      const uint32_t prev = order[i - 1], cur = order[i];
+      double gap = left[cur] - right[prev];
+      float spaceWidth = std::max(space[prev], space[cur]);
+      if (!std::isfinite(spaceWidth) || spaceWidth <= 0)
+        spaceWidth = 1.0f;
+      bool split = gap > spaceWidth * 1.5;
+      if (!split && verticalRulings)
+        split = verticalRulings->anyBetween(right[prev], left[cur],
+                                            std::min(top[prev], top[cur]),
+                                            std::max(bottom[prev], bottom[cur]));
+      if (split) {
+        out.words.push_back(Range{wordStart, i});
+        wordStart = i;
+      }
+    }
+    out.words.push_back(Range{wordStart, line.end});
+  }
+}
+
+TextStore::Range TextLayout::appendWords(const Grouping &g,
+                                         TextStore &out) const {
+  const uint32_t firstWord = static_cast<uint32_t>(out.size());
+  for (const Range &w : g.words) {
+    const uint32_t first = g.ids[w.begin];
+    float wTop = top[first];
+    float wLeft = left[first];
+    float wRight = right[first];
+    float wBottom = top[first] + height[first];
+    for (uint32_t i = w.begin; i < w.end; ++i) {
+      const uint32_t id = g.ids[i];
+      wTop = std::min(wTop, top[id]);
+      wLeft = std::min(wLeft, left[id]);
+      wRight = std::max(wRight, right[id]);
+      wBottom = std::max(wBottom, top[id] + height[id]);
+      out.appendText(*textStore, id);
+      if (i + 1 < w.end)
+        out.appendText(' ');
+    }
+    out.addElement(
+        TextStore::Box{wTop, wLeft, wRight - wLeft, wBottom - wTop});
+  }
+  return TextStore::Range{firstWord, static_cast<uint32_t>(out.size())};
+}
+
+std::vector<TextChunk> TextLayout::wordChunks(const Grouping &g) const {
+  TextStore words;
+  const TextStore::Range r = appendWords(g, words);
+  std::vector<TextChunk> out;
+  out.reserve(r.size());
+  for (uint32_t id = r.begin; id < r.end; ++id)
+    out.push_back(TextChunk(words.element(id)));
+  return out;
+}
+
+std::vector<TextChunk>
+TextLayout::mergeWords(const std::vector<uint32_t> &ids,
+                       const VerticalRulingIndex *verticalRulings) const {
+  Grouping g;
+  group(ids, verticalRulings, g);
+  return wordChunks(g);
+}
+
+} // namespace tabula
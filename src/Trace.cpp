@@ -0,0 +1,99 @@
+#include "tabula/Trace.h"
+#include "tabula/json/Escape.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tabula {
+
+namespace {
+
+struct TraceEvent {
+  const char *name;
+  const char *category;
+  int64_t start;
+  int64_t duration;
+  int tid;
+  int page;
+};
+
+std::atomic<bool> traceEnabled(false);
+std::mutex traceMutex;
+std::vector<TraceEvent> traceEvents;
+// Small stable ids for threads so viewers show one row per worker.
+std::map<std::thread::id, int> traceThreads;
+
+const std::chrono::steady_clock::time_point traceEpoch =
+    std::chrono::steady_clock::now();
+
+void writeJsonString(std::ostream &out, const char *s) {
+  out << '"';
+  json::writeEscaped(out, s, std::strlen(s));
+  out << '"';
+}
+
+} // namespace
+
+void Trace::start() {
+  std::lock_guard<std::mutex> lock(traceMutex);
+  traceEvents.clear();
+  traceThreads.clear();
+  traceEnabled.store(true, std::memory_order_relaxed);
+}
+
+void Trace::stop() { traceEnabled.store(false, std::memory_order_relaxed); }
+
+bool Trace::enabled() { return traceEnabled.load(std::memory_order_relaxed); }
+
+int64_t Trace::nowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - traceEpoch)
+      .count();
+}
+
+void Trace::record(const char *name, const char *category, int64_t startUs,
+                   int64_t durationUs, int page) {
+  std::lock_guard<std::mutex> lock(traceMutex);
+  auto id = std::this_thread::get_id();
+  auto it = traceThreads.find(id);
+  if (it == traceThreads.end())
+    it = traceThreads.insert(std::make_pair(id, (int)traceThreads.size() + 1))
+             .first;
+  traceEvents.push_back(
+      TraceEvent{name, category, startUs, durationUs, it->second, page});
+}
+
+void Trace::writeJson(std::ostream &out) {
+  std::lock_guard<std::mutex> lock(traceMutex);
+  out << "{\"traceEvents\":[";
+  for (size_t i = 0; i < traceEvents.size(); ++i) {
+    const auto &e = traceEvents[i];
+    if (i)
+      out << ",";
+    out << "\n{\"name\":";
+    writeJsonString(out, e.name);
+    out << ",\"cat\":";
+    writeJsonString(out, e.category);
+    out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid << ",\"ts\":" << e.start
+        << ",\"dur\":" << e.duration;
+    if (e.page > 0)
+      out << ",\"args\":{\"page\":" << e.page << "}";
+    out << "}";
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool Trace::writeJson(const std::string &path) {
+  std::ofstream out(path, std::ios::binary);
+  if (!out)
+    return false;
+  writeJson(out);
+  return static_cast<bool>(out);
+}
+
+} // namespace tabula
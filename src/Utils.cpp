@@ -1,5 +1,68 @@
 #include "tabula/Utils.h"
 
 namespace tabula {
-// All methods are inline in the header for now.
+
+void Utils::radixSortIndices(const std::vector<uint32_t> &keys,
+                             std::vector<uint32_t> &order) {
+  const size_t n = order.size();
+  if (n < 64) {
+    std::stable_sort(order.begin(), order.end(),
+                     [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    return;
+  }
+  static thread_local std::vector<uint32_t> tmp;
+  tmp.resize(n);
+  uint32_t *src = order.data();
+  uint32_t *dst = tmp.data();
+  for (int shift = 0; shift < 32; shift += 8) {
+    size_t count[257] = {0};
+    for (size_t i = 0; i < n; ++i)
+      ++count[((keys[src[i]] >> shift) & 0xffu) + 1];
+    // every key has the same byte here: nothing to reorder
+    bool single = false;
+    for (int b = 1; b <= 256; ++b)
+      if (count[b] == n) {
+        single = true;
+        break;
+      }
+    if (single)
+      continue;
+    for (int b = 1; b <= 256; ++b)
+      count[b] += count[b - 1];
+    for (size_t i = 0; i < n; ++i)
+      dst[count[(keys[src[i]] >> shift) & 0xffu]++] = src[i];
+    std::swap(src, dst);
+  }
+  if (src != order.data())
+    std::copy(src, src + n, order.data());
 }
+
+void Utils::snapValues(std::vector<float> &values, float threshold) {
+  const size_t n = values.size();
+  // |a - b| < threshold never holds: every value is its own group
+  if (n == 0 || !(threshold > 0))
+    return;
+  static thread_local std::vector<uint32_t> keys;
+  static thread_local std::vector<uint32_t> order;
+  keys.resize(n);
+  order.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = floatKey(values[i]);
+    order[i] = static_cast<uint32_t>(i);
+  }
+  radixSortIndices(keys, order);
+
+  for (size_t g = 0; g < n;) {
+    const float first = values[order[g]];
+    float sum = first;
+    size_t e = g + 1;
+    while (e < n && std::fabs(values[order[e]] - first) < threshold)
+      sum += values[order[e++]];
+    const float avg = sum / static_cast<float>(e - g);
+    for (size_t k = g; k < e; ++k)
+      values[order[k]] = avg;
+    g = e;
+  }
+}
+
+} // namespace tabula
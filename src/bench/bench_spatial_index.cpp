@@ -0,0 +1,160 @@
+// Benchmark: uniform-grid RectangleSpatialIndex vs packed RectangleRTree.
+//
+// For every page, both indexes are built over the page's text boxes plus the
+// kind of large rectangles tables produce (the page frame and a full-width
+// band per text line), then queried with every box (overlap) and with the
+// "below and to the left" containment region TableWithRulingLines uses.
+//
+//   make bench                      # runs over pdf/*.pdf when built with
+//                                   # Poppler, a synthetic corpus otherwise
+//   build/bin/tabula-bench_spatial_index a.pdf ...
+#include "tabula/RectangleRTree.h"
+#include "tabula/RectangleSpatialIndex.h"
+#ifdef HAVE_POPPLER
+#include "tabula/PageSnapshot.h"
+#include <memory>
+#include <poppler/cpp/poppler-document.h>
+#include <poppler/cpp/poppler-page.h>
+#endif
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace tabula;
+
+typedef std::vector<Rectangle> PageBoxes;
+
+static void addTableFrames(PageBoxes &page, float width, float height) {
+  std::set<int> lines;
+  size_t glyphs = page.size();
+  for (size_t i = 0; i < glyphs; ++i)
+    lines.insert(static_cast<int>(page[i].getTop()));
+  page.push_back(Rectangle(0, 0, width, height));
+  for (int top : lines)
+    page.push_back(Rectangle(static_cast<float>(top), 0, width, 8));
+}
+
+#ifdef HAVE_POPPLER
+static bool loadCorpus(const std::vector<std::string> &paths,
+                       std::vector<PageBoxes> &pages) {
+  for (const auto &path : paths) {
+    std::unique_ptr<poppler::document> doc(
+        poppler::document::load_from_file(path));
+    if (!doc) {
+      std::cerr << "skipping " << path << ": cannot open" << std::endl;
+      continue;
+    }
+    for (int i = 0; i < doc->pages(); ++i) {
+      std::unique_ptr<poppler::page> p(doc->create_page(i));
+      if (!p)
+        continue;
+      PageSnapshot snap = PageSnapshot::fromPoppler(*p);
+      PageBoxes boxes;
+      for (const auto &b : snap.boxes)
+        boxes.push_back(Rectangle(b.top, b.left, b.width, b.height));
+      addTableFrames(boxes, snap.width, snap.height);
+      pages.push_back(boxes);
+    }
+  }
+  return !pages.empty();
+}
+#endif
+
+// Deterministic stand-in for the corpus: text-heavy pages with glyph-sized
+// boxes on a line grid.
+static void syntheticCorpus(std::vector<PageBoxes> &pages) {
+  std::srand(42);
+  for (int p = 0; p < 40; ++p) {
+    PageBoxes boxes;
+    for (int line = 0; line < 60; ++line) {
+      float x = 36.0f;
+      while (x < 560.0f) {
+        float w = 4.0f + static_cast<float>(std::rand() % 5);
+        boxes.push_back(Rectangle(36.0f + line * 12.0f, x, w, 9.0f));
+        x += w + ((std::rand() % 7 == 0) ? 12.0f : 1.0f);
+      }
+    }
+    addTableFrames(boxes, 612.0f, 792.0f);
+    pages.push_back(boxes);
+  }
+}
+
+template <typename Index> struct Result {
+  double buildMs = 0, overlapMs = 0, containsMs = 0;
+  size_t hits = 0;
+};
+
+template <typename Index>
+static Result<Index> run(const std::vector<PageBoxes> &pages, int reps) {
+  typedef std::chrono::steady_clock Clock;
+  auto ms = [](Clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+  };
+  Result<Index> res;
+  for (int rep = 0; rep < reps; ++rep) {
+    for (const auto &page : pages) {
+      auto t0 = Clock::now();
+      Index index;
+      for (const auto &r : page)
+        index.add(r);
+      Rectangle bounds = index.getBounds(); // forces the lazy build
+      auto t1 = Clock::now();
+      for (const auto &r : page)
+        index.forEachId(r, [&](size_t) { ++res.hits; });
+      auto t2 = Clock::now();
+      for (const auto &r : page) {
+        Rectangle q(r.getBottom(), bounds.getLeft(),
+                    r.getLeft() - bounds.getLeft(),
+                    bounds.getBottom() - r.getBottom());
+        res.hits += index.containsIds(q).size();
+      }
+      auto t3 = Clock::now();
+      res.buildMs += ms(t1 - t0);
+      res.overlapMs += ms(t2 - t1);
+      res.containsMs += ms(t3 - t2);
+    }
+  }
+  return res;
+}
+
+template <typename Index>
+static void report(const char *name, const Result<Index> &r) {
+  std::printf("%-8s build %9.2f ms  overlap %9.2f ms  contains %9.2f ms  "
+              "hits %zu\n",
+              name, r.buildMs, r.overlapMs, r.containsMs, r.hits);
+}
+
+int main(int argc, char **argv) {
+  std::vector<PageBoxes> pages;
+  std::vector<std::string> paths(argv + 1, argv + argc);
+#ifdef HAVE_POPPLER
+  if (!paths.empty() && !loadCorpus(paths, pages))
+    return 1;
+#else
+  if (!paths.empty())
+    std::cerr << "built without Poppler; using the synthetic corpus"
+              << std::endl;
+#endif
+  if (pages.empty())
+    syntheticCorpus(pages);
+
+  size_t boxes = 0;
+  for (const auto &p : pages)
+    boxes += p.size();
+  std::printf("%zu pages, %zu rectangles\n", pages.size(), boxes);
+
+  const int reps = 3;
+  auto grid = run<RectangleSpatialIndex<Rectangle>>(pages, reps);
+  auto rtree = run<RectangleRTree<Rectangle>>(pages, reps);
+  report("grid", grid);
+  report("rtree", rtree);
+  if (grid.hits != rtree.hits) {
+    std::cerr << "result mismatch between indexes" << std::endl;
+    return 1;
+  }
+  return 0;
+}
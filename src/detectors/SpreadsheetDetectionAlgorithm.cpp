@@ -6,9 +6,9 @@ namespace detectors {
 
 std::vector<Rectangle>
 SpreadsheetDetectionAlgorithm::detect(const Page &page) const {
+  const std::shared_ptr<const RulingSet> rulings = page.getRulingSet();
   std::vector<Cell> cells = SpreadsheetExtractionAlgorithm::findCells(
-      page.getCollapsedHorizontalRulings(page.getUnprocessedRulings()),
-      page.getCollapsedVerticalRulings(page.getUnprocessedRulings()));
+      rulings->getHorizontalRulings(), rulings->getVerticalRulings());
   std::vector<Rectangle> tables =
       SpreadsheetExtractionAlgorithm::findSpreadsheetsFromCells(
           std::vector<Rectangle>(cells.begin(), cells.end()));
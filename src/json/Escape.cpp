@@ -0,0 +1,52 @@
+#include "tabula/json/Escape.h"
+#include <sstream>
+
+namespace tabula {
+namespace json {
+
+namespace {
+
+// The escape sequence for `c`, or nullptr to copy it as is.
+const char *escapeFor(char c) {
+  // \u00XX for the controls without a short form
+  static const char *const controls[0x20] = {
+      "\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005",
+      "\\u0006", "\\u0007", "\\b",     "\\t",     "\\n",     "\\u000b",
+      "\\f",     "\\r",     "\\u000e", "\\u000f", "\\u0010", "\\u0011",
+      "\\u0012", "\\u0013", "\\u0014", "\\u0015", "\\u0016", "\\u0017",
+      "\\u0018", "\\u0019", "\\u001a", "\\u001b", "\\u001c", "\\u001d",
+      "\\u001e", "\\u001f"};
+  const unsigned char u = static_cast<unsigned char>(c);
+  if (u < 0x20)
+    return controls[u];
+  if (c == '"')
+    return "\\\"";
+  if (c == '\\')
+    return "\\\\";
+  return nullptr;
+}
+
+} // namespace
+
+// Copies the plain runs between escapes in one piece.
+void writeEscaped(std::ostream &o, const char *s, size_t n) {
+  size_t from = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const char *esc = escapeFor(s[i]);
+    if (!esc)
+      continue;
+    o.write(s + from, static_cast<std::streamsize>(i - from));
+    o << esc;
+    from = i + 1;
+  }
+  o.write(s + from, static_cast<std::streamsize>(n - from));
+}
+
+std::string escape(const std::string &s) {
+  std::ostringstream o;
+  writeEscaped(o, s);
+  return o.str();
+}
+
+} // namespace json
+} // namespace tabula
@@ -2,57 +2,13 @@
 #include "tabula/Table.h"
 #include "tabula/TextChunk.h"
 #include "tabula/Diagnostics.h"
+#include "tabula/json/Escape.h"
 #include <sstream>
-#include <iomanip>
 #include <iostream>
 
 namespace tabula {
 namespace json {
 
-static std::string escape(const std::string &s) {
-  std::ostringstream o;
-  for (char c : s) {
-    switch (c) {
-    case '"':
-      o << "\\\"";
-      break;
-    case '\\':
-    {
-      unsigned char uc = static_cast<unsigned char>(c);
-      if (uc < 0x20) {
-        // encode control characters as \u00XX
-        std::ostringstream hexs;
-        hexs << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << int(uc);
-        o << "\\u00" << hexs.str();
-      } else {
-        o << c;
-      }
-    }
-    break;
-      break;
-    case '\b':
-      o << "\\b";
-      break;
-    case '\f':
-      o << "\\f";
-      break;
-    case '\n':
-      o << "\\n";
-      break;
-    case '\r':
-      o << "\\r";
-      break;
-    case '\t':
-      o << "\\t";
-      break;
-    default:
-      o << c;
-      break;
-    }
-  }
-  return o.str();
-}
-
 // Note: we avoid declaring serializeRectangular for
 // RectangularTextContainer<std::string> because the generic template
 // implementation expects T to provide geometry methods.
@@ -65,7 +21,9 @@ serializeRectangular(const RectangularTextContainer<tabula::TextChunk> &rtc) {
   o << "\"left\":" << rtc.getLeft() << ",";
   o << "\"width\":" << rtc.getWidth() << ",";
   o << "\"height\":" << rtc.getHeight() << ",";
-  o << "\"text\":\"" << escape(rtc.getText()) << "\"";
+  o << "\"text\":\"";
+  writeEscaped(o, rtc.getText());
+  o << "\"";
   o << "}";
   return o.str();
 }
@@ -73,15 +31,14 @@ serializeRectangular(const RectangularTextContainer<tabula::TextChunk> &rtc) {
 std::string serializeTable(const Table &table) {
   std::ostringstream o;
   // Diagnostic dump: print table grid and each cell text length/sample to stderr
-  {
-    auto const &rows = table.getRows();
-    size_t rcount = rows.size();
-    size_t ccount = (rcount ? rows.front().size() : 0);
+  if (tabula::diagnosticsEnabled()) {
+    size_t rcount = static_cast<size_t>(table.getRowCount());
+    size_t ccount = rcount ? static_cast<size_t>(table.getColCount()) : 0;
     tabula::diag(std::string("[diag] serializeTable: page=") + std::to_string(table.getPageNumber()) + " rows=" + std::to_string(rcount) + " cols=" + std::to_string(ccount));
     for (size_t r = 0; r < rcount; ++r) {
       for (size_t c = 0; c < ccount; ++c) {
-        auto const &cell = rows[r][c];
-        std::string t = cell.getText();
+        auto const &cell = table.getRow(static_cast<int>(r))[c];
+        const std::string &t = cell.text();
         std::string sample = t.substr(0, std::min<size_t>(30, t.size()));
         // escape newlines in sample for compact logging
         for (char &ch : sample)
@@ -102,7 +59,8 @@ std::string serializeTable(const Table &table) {
   o << "\"bottom\":" << table.getRect().getBottom() << ",";
   o << "\"data\": [";
   bool firstRow = true;
-  for (auto const &row : table.getRows()) {
+  for (int r = 0; r < table.getRowCount(); ++r) {
+    const Table::RowView row = table.getRow(r);
     if (!firstRow)
       o << ",";
     firstRow = false;
@@ -118,7 +76,9 @@ std::string serializeTable(const Table &table) {
       o << "\"left\":" << cell.getLeft() << ",";
       o << "\"width\":" << cell.getWidth() << ",";
       o << "\"height\":" << cell.getHeight() << ",";
-      o << "\"text\":\"" << escape(cell.getText()) << "\"";
+      o << "\"text\":\"";
+      writeEscaped(o, cell.text());
+      o << "\"";
       o << "}";
     }
     o << "]";
@@ -1,28 +1,103 @@
 #include "tabula/Page.h"
 #include "tabula/ProjectionProfile.h"
+#include "tabula/Trace.h"
+#include <algorithm>
 
 namespace tabula {
 
+const SpatialIndex<Rectangle> &Page::getTextElementIndex() const {
+  if (textIndexBuilt)
+    return textIndex;
+  TABULA_TRACE_SCOPE("textIndex.build", pageNumber);
+  textIndex.clear();
+  textElementPositions.clear();
+  for (size_t c = 0; c < textChunks.size(); ++c) {
+    const auto &elements = textChunks[c].getTextElements();
+    for (size_t e = 0; e < elements.size(); ++e) {
+      const TextElement &te = elements[e];
+      textIndex.add(Rectangle(te.getTop(), te.getLeft(), te.getWidth(),
+                              te.getHeight()));
+      textElementPositions.push_back(
+          std::make_pair(static_cast<uint32_t>(c), static_cast<uint32_t>(e)));
+    }
+  }
+  textIndexBuilt = true;
+  return textIndex;
+}
+
+const TextElement &Page::getTextElement(size_t id) const {
+  getTextElementIndex();
+  const auto &pos = textElementPositions[id];
+  return textChunks[pos.first].getTextElements()[pos.second];
+}
+
+const TextLayout &Page::getTextLayout() const {
+  if (textLayout)
+    return *textLayout;
+  // same enumeration as the index, so the ids match
+  size_t count = 0, bytes = 0;
+  for (const auto &tc : textChunks)
+    for (const auto &te : tc.getTextElements()) {
+      ++count;
+      bytes += te.getTextView().size();
+    }
+  std::shared_ptr<TextStore> store = std::make_shared<TextStore>();
+  store->reserve(count, bytes);
+  for (const auto &tc : textChunks)
+    for (const auto &te : tc.getTextElements())
+      store->add(te);
+  textLayout = std::make_shared<const TextLayout>(std::move(store));
+  return *textLayout;
+}
+
+std::vector<uint32_t>
+Page::getTextElementIdsOverlapping(const Rectangle &area) const {
+  // The index returns every element whose box touches `area`; the exact
+  // overlapRatio test below keeps the original per-cell semantics.
+  std::vector<size_t> ids = getTextElementIndex().queryIds(area);
+  std::sort(ids.begin(), ids.end());
+  std::vector<uint32_t> out;
+  out.reserve(ids.size());
+  for (size_t id : ids) {
+    const TextElement &te = getTextElement(id);
+    if (te.overlapRatio(area) > 0.0f || area.overlapRatio(te) > 0.0f)
+      out.push_back(static_cast<uint32_t>(id));
+  }
+  return out;
+}
+
+std::vector<TextElement>
+Page::getTextElementsOverlapping(const Rectangle &area) const {
+  std::vector<TextElement> out;
+  for (uint32_t id : getTextElementIdsOverlapping(area)) {
+    out.push_back(getTextElement(id));
+    out.back().ownText();
+  }
+  return out;
+}
+
 std::vector<float> Page::findVerticalSeparators(float minColumnWidth) const {
+  TABULA_TRACE_SCOPE("separators.vertical", pageNumber);
   // Build rectangles from text chunks
   std::vector<Rectangle> elems;
   for (const auto &tc : textChunks)
     elems.push_back(tc);
 
   ProjectionProfile pp(*this, elems, 3.0f, 3.0f);
-  // pass explicit collapsed vertical rulings
-  auto explicitR = getCollapsedVerticalRulings(getUnprocessedRulings());
-  return pp.findVerticalSeparators(minColumnWidth, explicitR);
+  // pass the page's cleaned vertical rulings
+  return pp.findVerticalSeparators(minColumnWidth,
+                                   getRulingSet()->getVerticalIndex());
 }
 
 std::vector<float> Page::findHorizontalSeparators(float minRowHeight) const {
+  TABULA_TRACE_SCOPE("separators.horizontal", pageNumber);
   std::vector<Rectangle> elems;
   for (const auto &tc : textChunks)
     elems.push_back(tc);
 
   ProjectionProfile pp(*this, elems, 3.0f, 3.0f);
-  auto explicitR = getCollapsedHorizontalRulings(getUnprocessedRulings());
-  return pp.findHorizontalSeparators(minRowHeight, explicitR);
+  return pp.findHorizontalSeparators(minRowHeight,
+                                     getRulingSet()->getHorizontalIndex());
 }
 
 } // namespace tabula
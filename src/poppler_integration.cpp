@@ -2,149 +2,74 @@
 #include "tabula/ObjectExtractor.h"
 #include "tabula/SpreadsheetExtractionAlgorithm.h"
 #include "tabula/BasicExtractionAlgorithm.h"
+#include "tabula/CliSupport.h"
+#include "tabula/PageScheduler.h"
+#include "tabula/PageSnapshot.h"
+#include "tabula/Metrics.h"
+#include "tabula/PdfSource.h"
+#include "tabula/Trace.h"
 #include "tabula/TextElement.h"
 #include "tabula/writers/CSVWriter.h"
 #include "tabula/writers/JSONWriter.h"
 #include "tabula/writers/WriterFactory.h"
-#ifdef HAVE_POPPLER
 #include "tabula/ObjectExtractorPopplerEngine.h"
-#endif
 #include "tabula/Diagnostics.h"
+#include "tabula/poppler_integration.h"
+#include "tabula/pages.h"
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 #include <poppler/cpp/poppler-document.h>
 #include <poppler/cpp/poppler-page.h>
 
 using namespace tabula;
 
-// Map Poppler page text into TextElement vector using
-// poppler::page::text_list()
-static std::vector<TextElement> pageToTextElements(poppler::page &p) {
-  std::vector<TextElement> out;
-  auto text_list = p.text_list();
-  float page_h = 0.0f;
-  try {
-    auto rect = p.page_rect();
-    page_h = static_cast<float>(rect.height());
-  } catch (...) {
+// Run the full extraction pipeline for a single Poppler page. Each call only
+// touches the given page (and objects it creates), so pages belonging to
+// different poppler::document instances can be processed concurrently.
+static std::vector<Table> extractPageTables(poppler::page &p, int pageNumber) {
+  TABULA_TRACE_SCOPE("page", pageNumber);
+  // Ask Poppler for the page text layout once; both the TextElement builder
+  // and the ruling engine work from this snapshot.
+  PageSnapshot snapshot;
+  {
+    TABULA_TRACE_SCOPE("text_list", pageNumber);
+    snapshot = PageSnapshot::fromPoppler(p);
   }
-  for (const auto &item : text_list) {
-    // item is poppler::text_box (or text_box/line) - use text() and bounding
-    // box
-    try {
-      auto ba = item.text().to_utf8();
-      std::string s(ba.begin(), ba.end());
-  auto r = item.bbox();
-  // Poppler uses a coordinate system with origin at bottom-left; convert
-  // to our top-left origin by flipping Y using the page height.
-  float left = static_cast<float>(r.left());
-  float height = static_cast<float>(r.height());
-  float raw_top = static_cast<float>(r.top());
-  float top = (page_h > 0.0f) ? (page_h - (raw_top + height)) : raw_top;
-  float width = static_cast<float>(r.width());
-      // approximate width-of-space as 0.25 * font height; poppler doesn't
-      // expose it easily
-      float widthOfSpace = height * 0.25f;
-  out.emplace_back(top, left, width, height, s, widthOfSpace);
-    } catch (...) {
-      // ignore any item we can't process
-    }
+  // All of the page's text goes into one arena, released with the page.
+  std::shared_ptr<TextArena> arena = std::make_shared<TextArena>();
+  auto elements = snapshot.toTextElements(*arena);
+  if (Metrics::enabled()) {
+    Metrics::add(Metrics::PagesProcessed);
+    Metrics::add(Metrics::TextElements, elements.size());
+    Metrics::observeTextElementsPerPage(elements.size());
   }
-  return out;
-}
-
-// Diagnostics flag default
-bool tabula::diagnostics_enabled = false;
-
-int poppler_integration_run(const std::vector<std::string> &args,
-                            const std::vector<int> &pages) {
-  if (args.size() < 2) {
-    std::cerr << "Usage: poppler-integration [--format json|csv] [--delimiter "
-                 ",] [--no-page] [--header] <pdf-file>"
-              << std::endl;
-    return 2;
-  }
-
-  // Simple CLI parsing
-  std::string format = "json";
-  char delim = ',';
-  bool includePage = true;
-  bool includeHeader = false;
-  std::string pagesSpec;
-  std::string path;
-
-  for (size_t i = 1; i < args.size(); ++i) {
-    std::string a = args[i];
-    if (a == "--debug") {
-      tabula::diagnostics_enabled = true;
-      continue;
-    }
-    if (a == "--format" && i + 1 < args.size()) {
-      format = args[++i];
-    } else if (a == "--delimiter" && i + 1 < args.size()) {
-      delim = args[++i][0];
-    } else if (a == "--no-page") {
-      includePage = false;
-    } else if (a == "--header") {
-      includeHeader = true;
-    } else if (a == "--pages" && i + 1 < args.size()) {
-      pagesSpec = args[++i];
-    } else if (a.rfind("--", 0) == 0) {
-      std::cerr << "Unknown option: " << a << std::endl;
-      return 2;
-    } else {
-      path = a;
-    }
-  }
-  if (path.empty()) {
-    std::cerr << "Missing PDF path" << std::endl;
-    return 2;
-  }
-  std::unique_ptr<poppler::document> doc(
-      poppler::document::load_from_file(path));
-  if (!doc) {
-    std::cerr << "Failed to open PDF" << std::endl;
-    return 1;
-  }
-
-  auto writer =
-      tabula::writers::createWriter(format, delim, includePage, includeHeader);
-  int np = doc->pages();
-  std::vector<Table> allTables;
-  auto shouldProcess = [&](int pageIndex) {
-    if (pages.empty())
-      return true;
-    for (int p : pages)
-      if (p == pageIndex)
-        return true;
-    return false;
-  };
-  for (int i = 0; i < np; ++i) {
-    if (!shouldProcess(i + 1))
-      continue;
-    std::unique_ptr<poppler::page> p(doc->create_page(i));
-    if (!p)
-      continue;
-  auto elements = pageToTextElements(*p);
 
   // Create a Poppler raster-based engine to detect ruling lines and pass
   // it to ObjectExtractor so rulings are available to the extraction
   // algorithms (mirrors Java ObjectExtractorStreamEngine behavior).
-#ifdef HAVE_POPPLER
   tabula::ObjectExtractorPopplerEngine engine;
   try {
-    engine.analyze(*p);
+    TABULA_TRACE_SCOPE("engine.analyze", pageNumber);
+    engine.analyze(snapshot);
   } catch (...) {}
   ObjectExtractor oe(&engine, elements);
-#else
-  ObjectExtractor oe(nullptr, elements);
-#endif
-  Page page = oe.extractPage(i + 1);
+  oe.setTextArena(arena);
+  Page page;
+  {
+    TABULA_TRACE_SCOPE("extractPage", pageNumber);
+    page = oe.extractPage(pageNumber);
+  }
     // Diagnostic: report number of text chunks and a sample
-    try {
+    if (tabula::diagnosticsEnabled()) try {
       const auto &tchunks = page.getTextChunks();
-      tabula::diag(std::string("[diag] page ") + std::to_string(i + 1) + " textChunks=" + std::to_string(tchunks.size()));
+      tabula::diag(std::string("[diag] page ") + std::to_string(pageNumber) + " textChunks=" + std::to_string(tchunks.size()));
       if (!tchunks.empty()) {
         std::string s = tchunks.front().getText();
         if (s.size() > 120) s = s.substr(0, 120) + "...";
@@ -169,17 +94,10 @@ int poppler_integration_run(const std::vector<std::string> &args,
     // Set page dimensions from Poppler so the ProjectionProfile and
     // TableDetector operate over the correct area (otherwise Page is
     // zero-sized and separators are empty).
-    try {
-      auto rect = p->page_rect();
-      float pw = static_cast<float>(rect.width());
-      float ph = static_cast<float>(rect.height());
-      page.setLeft(0.0f);
-      page.setTop(0.0f);
-      page.setRight(pw);
-      page.setBottom(ph);
-    } catch (...) {
-      // ignore if poppler page rect can't be read
-    }
+    page.setLeft(0.0f);
+    page.setTop(0.0f);
+    page.setRight(snapshot.width);
+    page.setBottom(snapshot.height);
 
     // First try spreadsheet (ruling-based) extraction. If nothing found,
     // fall back to a simpler detection-based extraction so PDFs without
@@ -191,15 +109,14 @@ int poppler_integration_run(const std::vector<std::string> &args,
         // choose a reasonable min column/row size; 2.0 is a sensible default
         auto vSeps = page.findVerticalSeparators(2.0f);
         auto hSeps = page.findHorizontalSeparators(2.0f);
-        for (auto x : vSeps) {
-          Ruling vr(static_cast<double>(x), page.getTop(), static_cast<double>(x), page.getBottom());
-          page.addRuling(vr);
-        }
-        for (auto y : hSeps) {
-          Ruling hr(page.getLeft(), static_cast<double>(y), page.getRight(), static_cast<double>(y));
-          page.addRuling(hr);
-        }
-  tabula::diag(std::string("[diag] synthesized rulings v=") + std::to_string(vSeps.size()) + " h=" + std::to_string(hSeps.size()));
+        std::vector<Ruling> synthesized;
+        synthesized.reserve(vSeps.size() + hSeps.size());
+        for (auto x : vSeps)
+          synthesized.emplace_back(static_cast<double>(x), page.getTop(), static_cast<double>(x), page.getBottom());
+        for (auto y : hSeps)
+          synthesized.emplace_back(page.getLeft(), static_cast<double>(y), page.getRight(), static_cast<double>(y));
+        page.addRulings(synthesized);
+        TABULA_DIAG(std::string("[diag] synthesized rulings v=") + std::to_string(vSeps.size()) + " h=" + std::to_string(hSeps.size()));
       }
     } catch (...) {}
 
@@ -207,38 +124,247 @@ int poppler_integration_run(const std::vector<std::string> &args,
     if (tables.empty()) {
       tables = BasicExtractionAlgorithm().extract(page);
     }
-    
-    for (auto &t : tables)
-      allTables.push_back(std::move(t));
-  }
-  // If pagesSpec is provided, we would filter pages; for now pagesSpec is
-  // ignored and we process all pages
-  // Debug: print table structures and sample texts
-  // Diagnostic dump: print each table's cell texts (length + short sample)
-    for (size_t ti = 0; ti < allTables.size(); ++ti) {
-    const auto &t = allTables[ti];
+    return tables;
+}
+
+// Extract the given (zero-based) pages with `threads` workers. poppler-cpp
+// objects must not be shared between threads, so every worker opens its own
+// poppler::document over the same (mapped or in-memory) PDF bytes; pages
+// still reach `emit` in order.
+static void
+extractPagesParallel(const char *pdfData, int pdfSize,
+                     const std::vector<int> &pageIndices, int threads,
+                     const std::function<void(std::vector<Table> &)> &emit) {
+  std::mutex loadMutex;
+  auto makeWorker = [&]() -> tabula::PageExtractor {
+    std::shared_ptr<poppler::document> wdoc;
     {
-      std::ostringstream oss;
-      oss << "[diag] Table " << ti << " rows=" << t.getRowCount() << " cols=" << t.getColCount() << " rect=" << t.getRect();
-      tabula::diag(oss.str());
+      // Document loading touches Poppler's global state; serialize it.
+      std::lock_guard<std::mutex> lock(loadMutex);
+      TABULA_TRACE_SCOPE("load");
+      wdoc.reset(poppler::document::load_from_raw_data(pdfData, pdfSize));
     }
-    const auto &rows = t.getRows();
-    for (size_t r = 0; r < rows.size(); ++r) {
-      for (size_t c = 0; c < rows[r].size(); ++c) {
-        const auto &cell = rows[r][c];
-        std::string txt = cell.getText();
-        std::string sample = txt.substr(0, std::min<size_t>(50, txt.size()));
-        if (txt.size() > 50)
-          sample += "...";
-        tabula::diag(std::string("[diag] cell(") + std::to_string(r) + "," + std::to_string(c) + ") len=" + std::to_string(txt.size()) + " sample='" + sample + "'");
+    if (!wdoc)
+      throw std::runtime_error("worker failed to open PDF");
+    return [wdoc, &pageIndices](size_t k) {
+      std::vector<Table> tables;
+      std::unique_ptr<poppler::page> p(wdoc->create_page(pageIndices[k]));
+      if (p)
+        tables = extractPageTables(*p, pageIndices[k] + 1);
+      return tables;
+    };
+  };
+  tabula::extractInPageOrder(pageIndices.size(), threads, makeWorker, emit);
+}
+
+namespace {
+
+struct RunOptions {
+  std::string format = "json";
+  char delim = ',';
+  bool includePage = true;
+  bool includeHeader = false;
+  int threads = 1;
+  std::string path;
+  std::string tracePath;
+  std::string metricsPath;
+};
+
+} // namespace
+
+// Simple CLI parsing; returns 0 on success or the exit code to report.
+static int parseRunOptions(const std::vector<std::string> &args,
+                           RunOptions &opts) {
+  for (size_t i = 1; i < args.size(); ++i) {
+    std::string a = args[i];
+    if (a == "--debug") {
+      tabula::diagnostics_enabled = true;
+      continue;
+    }
+    if (a == "--format" && i + 1 < args.size()) {
+      opts.format = args[++i];
+    } else if (a == "--delimiter" && i + 1 < args.size()) {
+      opts.delim = args[++i][0];
+    } else if (a == "--no-page") {
+      opts.includePage = false;
+    } else if (a == "--header") {
+      opts.includeHeader = true;
+    } else if (a == "--pages" && i + 1 < args.size()) {
+      // pages are passed separately as parsed indices
+      ++i;
+    } else if (a == "--threads" && i + 1 < args.size()) {
+      if (!tabula::cli::parseThreads(args[++i], opts.threads)) {
+        std::cerr << "Invalid --threads value: " << args[i] << std::endl;
+        return 2;
       }
+    } else if (a == "--trace" && i + 1 < args.size()) {
+      opts.tracePath = args[++i];
+    } else if (a == "--metrics" && i + 1 < args.size()) {
+      opts.metricsPath = args[++i];
+    } else if (a.rfind("--", 0) == 0) {
+      std::cerr << "Unknown option: " << a << std::endl;
+      return 2;
+    } else {
+      opts.path = a;
     }
   }
+  return 0;
+}
+
+// Extract every requested page of the PDF held in [data, data + size) and
+// stream the tables to `out`. The bytes are read in place by Poppler.
+static int runDocument(const char *data, size_t size, const RunOptions &opts,
+                       const std::vector<int> &pages, std::ostream &out) {
+  // poppler::document::load_from_raw_data takes an int length
+  if (size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    std::cerr << "PDF too large to load from memory" << std::endl;
+    return 1;
+  }
+  const int pdfSize = static_cast<int>(size);
+  TABULA_TRACE_SCOPE("document");
+  std::unique_ptr<poppler::document> doc;
+  {
+    TABULA_TRACE_SCOPE("load");
+    doc.reset(poppler::document::load_from_raw_data(data, pdfSize));
+  }
+  if (!doc) {
+    std::cerr << "Failed to open PDF" << std::endl;
+    return 1;
+  }
+
+  auto writer = tabula::writers::createWriter(opts.format, opts.delim,
+                                              opts.includePage,
+                                              opts.includeHeader);
+  int np = doc->pages();
+  const std::vector<int> pageIndices = tabula::selectPages(pages, np);
 
-  writer->write(std::cout, allTables);
+  // Tables are streamed to the writer page by page so memory stays constant
+  // and output starts as soon as the first page is done.
+  size_t tableIndex = 0;
+  auto emitPage = [&](std::vector<Table> &tables) {
+    for (auto const &t : tables) {
+      // Diagnostic dump: print each table's cell texts (length + short sample)
+      if (tabula::diagnosticsEnabled()) {
+        std::ostringstream oss;
+        oss << "[diag] Table " << tableIndex << " rows=" << t.getRowCount() << " cols=" << t.getColCount() << " rect=" << t.getRect();
+        tabula::diag(oss.str());
+        for (int r = 0; r < t.getRowCount(); ++r) {
+          const Table::RowView row = t.getRow(r);
+          for (size_t c = 0; c < row.size(); ++c) {
+            const auto &cell = row[c];
+            const std::string &txt = cell.text();
+            std::string sample = txt.substr(0, std::min<size_t>(50, txt.size()));
+            if (txt.size() > 50)
+              sample += "...";
+            tabula::diag(std::string("[diag] cell(") + std::to_string(r) + "," + std::to_string(c) + ") len=" + std::to_string(txt.size()) + " sample='" + sample + "'");
+          }
+        }
+      }
+      TABULA_TRACE_SCOPE("writer.table", t.getPageNumber());
+      writer->writeTable(out, t);
+      ++tableIndex;
+    }
+    if (Metrics::enabled())
+      Metrics::add(Metrics::TablesEmitted, tables.size());
+    TABULA_TRACE_SCOPE("writer.flush");
+    out.flush();
+  };
+
+  // --threads 0 means "one worker per hardware thread"
+  int threads = opts.threads;
+  if (threads <= 0)
+    threads = static_cast<int>(std::thread::hardware_concurrency());
+  threads = std::max(1, std::min(threads, static_cast<int>(pageIndices.size())));
+
+  writer->begin(out);
+  if (threads > 1) {
+    extractPagesParallel(data, pdfSize, pageIndices, threads, emitPage);
+  } else {
+    for (int i : pageIndices) {
+      std::unique_ptr<poppler::page> p(doc->create_page(i));
+      if (!p)
+        continue;
+      auto tables = extractPageTables(*p, i + 1);
+      emitPage(tables);
+    }
+  }
+  writer->end(out);
+  out.flush();
   return 0;
 }
 
+// Run one document, recording a trace of it when --trace was given and
+// metrics when --metrics was given. Without those options a trace or metrics
+// collection started by the caller (e.g. a batch run) keeps recording.
+static int runDocumentInstrumented(const char *data, size_t size,
+                                   const RunOptions &opts,
+                                   const std::vector<int> &pages,
+                                   std::ostream &out) {
+  if (!opts.tracePath.empty())
+    tabula::Trace::start();
+  if (!opts.metricsPath.empty())
+    tabula::Metrics::start();
+  int rc;
+  if (tabula::Metrics::enabled()) {
+    tabula::cli::CountingStreambuf counter(out.rdbuf());
+    std::ostream countedOut(&counter);
+    rc = runDocument(data, size, opts, pages, countedOut);
+    tabula::Metrics::add(tabula::Metrics::BytesWritten, counter.count());
+  } else {
+    rc = runDocument(data, size, opts, pages, out);
+  }
+  if (!opts.tracePath.empty()) {
+    tabula::Trace::stop();
+    if (!tabula::Trace::writeJson(opts.tracePath))
+      std::cerr << "Failed to write trace: " << opts.tracePath << std::endl;
+  }
+  if (!opts.metricsPath.empty()) {
+    tabula::Metrics::stop();
+    if (!tabula::Metrics::writePrometheus(opts.metricsPath))
+      std::cerr << "Failed to write metrics: " << opts.metricsPath << std::endl;
+  }
+  return rc;
+}
+
+int poppler_integration_run(const std::vector<std::string> &args,
+                            const std::vector<int> &pages) {
+  if (args.size() < 2) {
+    std::cerr << "Usage: poppler-integration [--format json|csv] [--delimiter "
+                 ",] [--no-page] [--header] [--threads N] [--trace out.json] "
+                 "[--metrics out.prom] <pdf-file|->"
+              << std::endl;
+    return 2;
+  }
+
+  RunOptions opts;
+  int rc = parseRunOptions(args, opts);
+  if (rc != 0)
+    return rc;
+  if (opts.path.empty()) {
+    std::cerr << "Missing PDF path" << std::endl;
+    return 2;
+  }
+  // Files are memory-mapped and "-" reads stdin, so no temp files are needed
+  // and Poppler parses the bytes in place.
+  std::unique_ptr<tabula::PdfSource> src = tabula::PdfSource::open(opts.path);
+  if (!src) {
+    std::cerr << "Failed to open PDF" << std::endl;
+    return 1;
+  }
+  return runDocumentInstrumented(src->data(), src->size(), opts, pages, std::cout);
+}
+
+int poppler_integration_run_bytes(const char *data, size_t size,
+                                  const std::vector<std::string> &args,
+                                  std::ostream &out,
+                                  const std::vector<int> &pages) {
+  RunOptions opts;
+  int rc = parseRunOptions(args, opts);
+  if (rc != 0)
+    return rc;
+  return runDocumentInstrumented(data, size, opts, pages, out);
+}
+
 #else
 #include <iostream>
 int main() {
@@ -0,0 +1,69 @@
+#include "tabula/Cell.h"
+#include "tabula/Table.h"
+#include "tabula/TextStore.h"
+#include "tabula/writers/CSVWriter.h"
+#include "tabula/writers/JSONWriter.h"
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+using namespace tabula;
+
+int main() {
+  // assembled once, then the same string on every call
+  Cell c(0, 0, 100, 30);
+  c.addTextChunk(TextChunk(" say", 10.0f, 0.0f));
+  c.addTextChunk(TextChunk("\"hi\",", 10.0f, 30.0f));
+  c.addTextChunk(TextChunk("top ", 0.0f, 0.0f));
+  const std::string &first = c.text();
+  if (first != "top \r say\"hi\"," || &c.text() != &first ||
+      c.getText() != first || c.getText(false) != "top  say\"hi\",")
+    return 2;
+
+  // changing the words drops the cached text
+  c.addTextChunk(TextChunk("end", 20.0f, 0.0f));
+  if (c.text() != "top \r say\"hi\",\rend")
+    return 3;
+  std::shared_ptr<TextStore> store = std::make_shared<TextStore>();
+  store->add(TextElement(0, 0, 10, 8, std::string("x"), 1.0f));
+  store->add(TextElement(0, 20, 10, 8, std::string("y"), 1.0f));
+  c.setText(store, TextStore::Range{0, 1});
+  if (c.text() != "x")
+    return 4;
+  Cell next;
+  next.setText(store, TextStore::Range{1, 2});
+  c.mergeInPlace(next);
+  if (c.text() != "xy")
+    return 5;
+
+  // rows hand out cells whose text is already assembled
+  Table t;
+  t.setPageNumber(3);
+  t.add(c, 0, 0);
+  Cell quoted(0, 100, 50, 30);
+  quoted.addTextChunk(TextChunk("a \"b\"\tc", 0.0f, 100.0f));
+  t.add(quoted, 0, 1);
+  Cell slashed(0, 150, 50, 30);
+  slashed.addTextChunk(TextChunk("C:\\dir\x01", 0.0f, 150.0f));
+  t.add(slashed, 0, 2);
+  const Cell &placed = t.getRows()[0][1];
+  if (&placed.text() != &t.getRows()[0][1].text())
+    return 6;
+
+  // and the writers stream it, escaped, without reassembling it
+  std::ostringstream csv;
+  writers::CSVWriter(',').write(csv, t);
+  if (csv.str() != "3,xy,\"a \"\"b\"\"\tc\",C:\\dir\x01\n") {
+    std::cerr << "csv: " << csv.str() << std::endl;
+    return 7;
+  }
+  std::ostringstream json;
+  writers::JSONWriter().write(json, t);
+  // backslashes and bare control bytes are escaped too
+  if (json.str().find("\"text\":\"a \\\"b\\\"\\tc\"") == std::string::npos ||
+      json.str().find("\"text\":\"C:\\\\dir\\u0001\"") == std::string::npos) {
+    std::cerr << "json: " << json.str() << std::endl;
+    return 8;
+  }
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include "tabula/CliSupport.h"
+#include "tabula/json/Escape.h"
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace tabula;
+using namespace tabula::cli;
+
+int main() {
+  // blank lines and '#' comments are skipped, paths are trimmed
+  std::istringstream manifest("a.pdf\n\n   \n# skipped.pdf\n  #indented\n"
+                              "\tdir/b c.pdf  \r\nlast.pdf");
+  std::vector<std::string> paths;
+  readManifest(manifest, paths);
+  if (paths != std::vector<std::string>({"a.pdf", "dir/b c.pdf", "last.pdf"}))
+    return 2;
+  if (readManifest(std::string("/nonexistent/manifest.txt"), paths))
+    return 3;
+
+  // colliding base names get numbered, stdin gets a name of its own
+  std::set<std::string> used;
+  if (outputFileFor("out", "x/report.pdf", "csv", used) != "out/report.csv" ||
+      outputFileFor("out", "y\\report.PDF", "csv", used) !=
+          "out/report-2.csv" ||
+      outputFileFor("out", "report", "csv", used) != "out/report-3.csv" ||
+      outputFileFor("out", "-", "json", used) != "out/stdin.json" ||
+      outputFileFor("out", ".hidden", "json", used) != "out/.hidden.json")
+    return 4;
+
+  // the batch wrapper escapes file names like the serializers escape text
+  if (json::escape("a\"b\\c\n\r\t") != "a\\\"b\\\\c\\n\\r\\t" ||
+      json::escape(std::string("\x01z\x1f", 3)) != "\\u0001z\\u001f" ||
+      json::escape("caf\xc3\xa9") != "caf\xc3\xa9") {
+    std::cerr << "json::escape: " << json::escape("a\"b\\c\n\r\t")
+              << std::endl;
+    return 5;
+  }
+
+  // --threads takes a non-negative count, 0 for all cores
+  int threads = -1;
+  if (!parseThreads("0", threads) || threads != 0 ||
+      !parseThreads("12", threads) || threads != 12)
+    return 7;
+  const char *bad[] = {"", "abc", "-4", "+4", " 4", "4x", "2.5",
+                       "99999999999999999999"};
+  for (const char *spec : bad)
+    if (parseThreads(spec, threads) || threads != 12) {
+      std::cerr << "accepted --threads " << spec << std::endl;
+      return 8;
+    }
+
+  // bytes are counted on their way through
+  std::ostringstream sink;
+  CountingStreambuf counter(sink.rdbuf());
+  std::ostream counted(&counter);
+  counted << "[" << 42 << ']';
+  counted.flush();
+  if (counter.count() != 4 || sink.str() != "[42]")
+    return 6;
+  return 0;
+}
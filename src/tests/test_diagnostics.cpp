@@ -0,0 +1,35 @@
+#include "tabula/Diagnostics.h"
+#include <iostream>
+#include <string>
+
+static int built = 0;
+
+static std::string expensiveMessage() {
+  ++built;
+  return "[diag] test message";
+}
+
+int main() {
+  // disabled: the message expression must not be evaluated at all
+  tabula::diagnostics_enabled = false;
+  TABULA_DIAG(expensiveMessage());
+  if (built != 0) {
+    std::cerr << "diag message built while disabled" << std::endl;
+    return 2;
+  }
+
+  // enabled: evaluated exactly once (unless compiled out)
+  tabula::diagnostics_enabled = true;
+  TABULA_DIAG(expensiveMessage());
+  tabula::diagnostics_enabled = false;
+#ifdef TABULA_NO_DIAGNOSTICS
+  const int expected = 0;
+#else
+  const int expected = 1;
+#endif
+  if (built != expected) {
+    std::cerr << "diag message evaluated " << built << " times" << std::endl;
+    return 3;
+  }
+  return 0;
+}
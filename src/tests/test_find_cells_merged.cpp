@@ -0,0 +1,35 @@
+#include "tabula/Ruling.h"
+#include "tabula/SpreadsheetExtractionAlgorithm.h"
+#include <iostream>
+
+int main() {
+  using namespace tabula;
+  // 2 rows x 3 columns; the first two columns of the top row are merged
+  // (the x=10 vertical only spans the bottom row)
+  std::vector<Ruling> hs = {Ruling(0, 0, 30, 0), Ruling(0, 10, 30, 10),
+                            Ruling(0, 20, 30, 20)};
+  std::vector<Ruling> vs = {Ruling(0, 0, 0, 20), Ruling(10, 10, 10, 20),
+                            Ruling(20, 0, 20, 20), Ruling(30, 0, 30, 20)};
+  auto cells = SpreadsheetExtractionAlgorithm::findCells(hs, vs);
+  const float expected[][4] = {// top, left, width, height
+                               {0, 0, 20, 10},
+                               {0, 20, 10, 10},
+                               {10, 0, 10, 10},
+                               {10, 10, 10, 10},
+                               {10, 20, 10, 10}};
+  if (cells.size() != 5) {
+    std::cerr << "expected 5 cells, got " << cells.size() << std::endl;
+    return 2;
+  }
+  for (size_t i = 0; i < cells.size(); ++i) {
+    const Cell &c = cells[i];
+    if (c.getTop() != expected[i][0] || c.getLeft() != expected[i][1] ||
+        c.getWidth() != expected[i][2] || c.getHeight() != expected[i][3]) {
+      std::cerr << "unexpected cell " << i << ": " << c.getTop() << ","
+                << c.getLeft() << " " << c.getWidth() << "x" << c.getHeight()
+                << std::endl;
+      return 3;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "tabula/Metrics.h"
+#include "tabula/Page.h"
+#include "tabula/Ruling.h"
+#include "tabula/SpreadsheetExtractionAlgorithm.h"
+#include "tabula/Trace.h"
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+int main() {
+  using namespace tabula;
+
+  // nothing is collected until start()
+  {
+    TABULA_TRACE_SCOPE("idle");
+  }
+  Metrics::start();
+  if (Metrics::stageCount("idle") != 0)
+    return 2;
+
+  // a 2x3 grid: 3 horizontals x 4 verticals, 6 cells
+  Page page(1);
+  page.setLeft(0.0f);
+  page.setTop(0.0f);
+  page.setRight(300.0f);
+  page.setBottom(100.0f);
+  for (double y : {0.0, 50.0, 100.0})
+    page.addRuling(Ruling(0, y, 300, y));
+  for (double x : {0.0, 100.0, 200.0, 300.0})
+    page.addRuling(Ruling(x, 0, x, 100));
+  SpreadsheetExtractionAlgorithm().extract(page);
+  Metrics::stop();
+
+  if (Metrics::value(Metrics::RulingsBeforeCollapse) != 7 ||
+      Metrics::value(Metrics::RulingsAfterCollapse) != 7 ||
+      Metrics::value(Metrics::IntersectionsTested) != 12 ||
+      Metrics::value(Metrics::CellsFound) != 6) {
+    std::cerr << "unexpected counters: rulings="
+              << Metrics::value(Metrics::RulingsBeforeCollapse) << "/"
+              << Metrics::value(Metrics::RulingsAfterCollapse)
+              << " intersections="
+              << Metrics::value(Metrics::IntersectionsTested)
+              << " cells=" << Metrics::value(Metrics::CellsFound) << std::endl;
+    return 3;
+  }
+  if (Metrics::stageCount("spreadsheet.extract") != 1 ||
+      Metrics::stageCount("spreadsheet.findCells") != 1) {
+    std::cerr << "stage latencies not recorded" << std::endl;
+    return 4;
+  }
+
+  std::ostringstream out;
+  Metrics::writePrometheus(out);
+  const std::string text = out.str();
+  if (text.find("# TYPE tabula_cells_found_total counter\n"
+                "tabula_cells_found_total 6\n") == std::string::npos ||
+      text.find("tabula_stage_duration_seconds_count{stage=\"spreadsheet."
+                "findCells\"} 1\n") == std::string::npos ||
+      text.find("tabula_stage_duration_seconds_bucket{stage=\"spreadsheet."
+                "extract\",le=\"+Inf\"} 1\n") == std::string::npos) {
+    std::cerr << "unexpected exposition:\n" << text << std::endl;
+    return 5;
+  }
+
+  // sums keep their full precision
+  Metrics::start();
+  Metrics::observeStage("long", 1234.56789);
+  Metrics::stop();
+  std::ostringstream precise;
+  Metrics::writePrometheus(precise);
+  const std::string sumKey =
+      "tabula_stage_duration_seconds_sum{stage=\"long\"} ";
+  const size_t at = precise.str().find(sumKey);
+  if (at == std::string::npos ||
+      std::strtod(precise.str().c_str() + at + sumKey.size(), nullptr) !=
+          1234.56789) {
+    std::cerr << "sum lost precision:\n" << precise.str() << std::endl;
+    return 7;
+  }
+
+  Metrics::reset();
+  if (Metrics::value(Metrics::CellsFound) != 0 ||
+      Metrics::stageCount("spreadsheet.extract") != 0)
+    return 6;
+  return 0;
+}
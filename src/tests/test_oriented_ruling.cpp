@@ -0,0 +1,63 @@
+#include "tabula/OrientedRuling.h"
+#include "tabula/Page.h"
+#include <cstdlib>
+#include <iostream>
+
+using namespace tabula;
+
+int main() {
+  // typed accessors agree with the Ruling they were built from
+  Ruling h(10, 5, 110, 5), v(40, 0, 40, 80);
+  HorizontalRuling oh(h);
+  VerticalRuling ov(v);
+  if (oh.getPosition() != 5 || oh.getStart() != 10 || oh.getEnd() != 110 ||
+      oh.getLeft() != 10 || oh.getBottom() != 5)
+    return 2;
+  if (ov.getPosition() != 40 || ov.getStart() != 0 || ov.getEnd() != 80 ||
+      ov.getRight() != 40 || ov.getTop() != 0)
+    return 3;
+  if (!ov.toRuling().vertical() || ov.toRuling().getBottom() != 80)
+    return 4;
+
+  // collapseRulings matches Ruling::collapseOrientedRulings on segments that
+  // share lines, overlap, touch within the expand amount or stand alone
+  std::srand(3);
+  std::vector<Ruling> segs;
+  std::vector<VerticalRuling> typed;
+  for (int i = 0; i < 400; ++i) {
+    double x = (std::rand() % 40) * 2.5;
+    double y = std::rand() % 300;
+    segs.push_back(Ruling(x, y, x, y + std::rand() % 30));
+    if (segs.back().vertical())
+      typed.emplace_back(segs.back());
+    else
+      segs.pop_back();
+  }
+  auto expected = Ruling::collapseOrientedRulings(segs);
+  auto got = collapseRulings(typed);
+  if (got.size() != expected.size()) {
+    std::cerr << "collapsed: got " << got.size() << " expected "
+              << expected.size() << std::endl;
+    return 5;
+  }
+  for (size_t i = 0; i < got.size(); ++i)
+    if (got[i].getPosition() != expected[i].getPosition() ||
+        got[i].getStart() != expected[i].getStart() ||
+        got[i].getEnd() != expected[i].getEnd())
+      return 6;
+
+  // the page's rulings split by orientation as they were added
+  Page page(1);
+  page.addRuling(h);
+  page.addRuling(v);
+  page.addRuling(Ruling(0, 0, 100, 3)); // within 5 degrees: forced horizontal
+  std::vector<HorizontalRuling> inputH;
+  std::vector<VerticalRuling> inputV;
+  splitRulings(page.getUnprocessedRulings(), inputH, inputV);
+  if (inputH.size() != 2 || inputV.size() != 1)
+    return 7;
+  if (page.getHorizontalRulings().size() + page.getVerticalRulings().size() !=
+      page.getRulings().size())
+    return 8;
+  return 0;
+}
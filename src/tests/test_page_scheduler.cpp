@@ -0,0 +1,61 @@
+#include "tabula/PageScheduler.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tabula;
+
+int main() {
+  // --threads N: later pages often finish first, yet tables come out in
+  // page order
+  const size_t n = 40;
+  std::atomic<int> workers(0);
+  auto makeWorker = [&]() -> PageExtractor {
+    ++workers;
+    return [](size_t k) {
+      std::this_thread::sleep_for(std::chrono::microseconds((n - k) * 200));
+      std::vector<Table> tables(k % 3);
+      for (auto &t : tables)
+        t.setPageNumber(static_cast<int>(k) + 1);
+      return tables;
+    };
+  };
+  std::vector<int> pages;
+  size_t calls = 0;
+  extractInPageOrder(n, 4, makeWorker, [&](std::vector<Table> &tables) {
+    ++calls;
+    for (auto const &t : tables)
+      pages.push_back(t.getPageNumber());
+  });
+  if (workers != 4 || calls != n)
+    return 2;
+  for (size_t i = 1; i < pages.size(); ++i)
+    if (pages[i] < pages[i - 1]) {
+      std::cerr << "page " << pages[i] << " emitted after " << pages[i - 1]
+                << std::endl;
+      return 3;
+    }
+
+  // a failing page stops the run and reaches the caller
+  try {
+    extractInPageOrder(
+        n, 3,
+        []() -> PageExtractor {
+          return [](size_t k) -> std::vector<Table> {
+            if (k == 7)
+              throw std::runtime_error("page 8");
+            return std::vector<Table>();
+          };
+        },
+        [](std::vector<Table> &) {});
+    return 4;
+  } catch (const std::runtime_error &e) {
+    if (std::string(e.what()) != "page 8")
+      return 5;
+  }
+  return 0;
+}
@@ -0,0 +1,44 @@
+#include "tabula/ObjectExtractorPopplerEngine.h"
+#include "tabula/PageSnapshot.h"
+#include <cmath>
+#include <iostream>
+
+int main() {
+  using namespace tabula;
+  PageSnapshot snap;
+  snap.width = 200.0f;
+  snap.height = 100.0f;
+  // three boxes sharing a left edge at x=10 on three different lines
+  const char *words[] = {"alpha", "beta", "gamma"};
+  for (int i = 0; i < 3; ++i) {
+    PageSnapshot::TextBox b;
+    b.top = 10.0f + 20.0f * i;
+    b.left = 10.0f;
+    b.width = 30.0f + 10.0f * i;
+    b.height = 8.0f;
+    b.text = words[i];
+    snap.boxes.push_back(b);
+  }
+
+  auto elems = snap.toTextElements();
+  if (elems.size() != 3 || elems[1].getText() != "beta")
+    return 2;
+  if (std::abs(elems[0].getWidthOfSpace() - 2.0f) > 1e-6f)
+    return 3;
+
+  ObjectExtractorPopplerEngine engine;
+  engine.analyze(snap);
+  bool foundLeftEdge = false;
+  for (auto const &r : engine.getRulings()) {
+    if (r.vertical() && std::abs(r.getLeft() - 10.0) < 1e-6 &&
+        std::abs(r.getBottom() - 100.0) < 1e-6)
+      foundLeftEdge = true;
+  }
+  if (!foundLeftEdge) {
+    std::cerr << "expected a vertical ruling at the shared left edge"
+              << std::endl;
+    return 4;
+  }
+  std::cout << "page_snapshot OK" << std::endl;
+  return 0;
+}
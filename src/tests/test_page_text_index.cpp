@@ -0,0 +1,67 @@
+#include "tabula/Page.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace tabula;
+
+// the per-cell selection the extraction algorithms used before the index
+static std::vector<std::string> bruteForce(const Page &page,
+                                           const Rectangle &area) {
+  std::vector<std::string> out;
+  for (auto const &tc : page.getTextChunks())
+    for (auto const &te : tc.getTextElements())
+      if (te.overlapRatio(area) > 0.0f || area.overlapRatio(te) > 0.0f)
+        out.push_back(te.getText());
+  return out;
+}
+
+static std::vector<std::string> indexed(const Page &page,
+                                        const Rectangle &area) {
+  std::vector<std::string> out;
+  for (auto const &te : page.getTextElementsOverlapping(area))
+    out.push_back(te.getText());
+  return out;
+}
+
+int main() {
+  Page page(1);
+  std::srand(3);
+  int n = 0;
+  for (int line = 0; line < 40; ++line) {
+    TextChunk chunk;
+    for (int k = 0; k < 30; ++k) {
+      float left = 10.0f + k * 18.0f + static_cast<float>(std::rand() % 4);
+      chunk.add(TextElement(10.0f + line * 12.0f, left,
+                            4.0f + static_cast<float>(std::rand() % 10), 9.0f,
+                            std::to_string(n++), 2.0f));
+    }
+    page.addTextChunk(chunk);
+  }
+  // zero-sized and touching elements must behave exactly as before
+  page.addTextChunk(TextChunk("empty", 100.0f, 100.0f));
+
+  for (int i = 0; i < 200; ++i) {
+    Rectangle cell(static_cast<float>(std::rand() % 500),
+                   static_cast<float>(std::rand() % 560),
+                   static_cast<float>(std::rand() % 120),
+                   static_cast<float>(std::rand() % 40));
+    if (indexed(page, cell) != bruteForce(page, cell)) {
+      std::cerr << "text index selection differs from brute force"
+                << std::endl;
+      return 2;
+    }
+  }
+  if (indexed(page, Rectangle(99, 99, 2, 2)) !=
+      bruteForce(page, Rectangle(99, 99, 2, 2)))
+    return 3;
+
+  // adding a chunk invalidates the cached index
+  page.addTextChunk(TextChunk(TextElement(900, 900, 5, 5, "late", 1.0f)));
+  auto late = indexed(page, Rectangle(899, 899, 10, 10));
+  if (late.size() != 1 || late[0] != "late")
+    return 4;
+  if (page.getTextElement(0).getText() != "0")
+    return 5;
+  return 0;
+}
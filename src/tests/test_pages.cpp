@@ -0,0 +1,21 @@
+#include "tabula/pages.h"
+#include <iostream>
+#include <vector>
+
+using namespace tabula;
+
+int main() {
+  // --pages is one-based; the selected indices are zero-based
+  if (selectPages(parsePagesSpec("1"), 4) != std::vector<int>{0})
+    return 2;
+  if (selectPages(parsePagesSpec("2-3"), 4) != std::vector<int>({1, 2}))
+    return 3;
+  // document order, and pages past the end are dropped
+  if (selectPages(parsePagesSpec("4,1,9"), 4) != std::vector<int>({0, 3}))
+    return 4;
+  if (selectPages(std::vector<int>(), 3) != std::vector<int>({0, 1, 2})) {
+    std::cerr << "no --pages should select every page" << std::endl;
+    return 5;
+  }
+  return 0;
+}
@@ -0,0 +1,45 @@
+#include "tabula/PdfSource.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+int main() {
+  using namespace tabula;
+  const std::string payload("%PDF-1.4\n%fake body\0with nul\n%%EOF\n", 35);
+
+  // caller buffers are borrowed, not copied
+  auto borrowed = PdfSource::fromBuffer(payload.data(), payload.size());
+  if (!borrowed || borrowed->data() != payload.data() ||
+      borrowed->size() != payload.size())
+    return 2;
+
+  // streams (stdin) are read completely, including embedded NULs
+  std::istringstream in(payload);
+  auto streamed = PdfSource::fromStream(in);
+  if (!streamed ||
+      std::string(streamed->data(), streamed->size()) != payload)
+    return 3;
+
+  // files are mapped (or read) with identical contents
+  const char *path = "tabula_pdfsource_test.tmp";
+  {
+    std::ofstream out(path, std::ios::binary);
+    out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+  }
+  {
+    auto mapped = PdfSource::open(path);
+    if (!mapped || std::string(mapped->data(), mapped->size()) != payload) {
+      std::remove(path);
+      return 4;
+    }
+  }
+  std::remove(path);
+
+  if (PdfSource::fromFile("does/not/exist.pdf"))
+    return 5;
+
+  std::cout << "pdfsource OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include "tabula/RectangleRTree.h"
+#include "tabula/RectangleSpatialIndex.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+using namespace tabula;
+
+int main() {
+  RectangleRTree<Rectangle> empty;
+  if (!empty.queryIds(Rectangle(0, 0, 10, 10)).empty() ||
+      empty.nearestId(0, 0) != RectangleRTree<Rectangle>::npos)
+    return 2;
+
+  // mixed sizes: glyph boxes plus page-sized frames, enough objects for a
+  // multi-level tree; results must match the grid exactly
+  RectangleRTree<Rectangle> tree;
+  RectangleSpatialIndex<Rectangle> grid;
+  std::vector<Rectangle> all;
+  std::srand(11);
+  for (int i = 0; i < 2000; ++i) {
+    Rectangle r = (i % 100 == 0)
+                      ? Rectangle(0, 0, 612, 792)
+                      : Rectangle(static_cast<float>(std::rand() % 780),
+                                  static_cast<float>(std::rand() % 600),
+                                  static_cast<float>(2 + std::rand() % 8),
+                                  static_cast<float>(2 + std::rand() % 10));
+    all.push_back(r);
+    tree.add(r);
+    grid.add(r);
+  }
+  for (int i = 0; i < 300; ++i) {
+    Rectangle area(static_cast<float>(std::rand() % 900) - 50,
+                   static_cast<float>(std::rand() % 700) - 50,
+                   static_cast<float>(std::rand() % 150),
+                   static_cast<float>(std::rand() % 150));
+    auto a = tree.queryIds(area), b = grid.queryIds(area);
+    auto c = tree.containsIds(area), d = grid.containsIds(area);
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    std::sort(c.begin(), c.end());
+    std::sort(d.begin(), d.end());
+    if (a != b || c != d) {
+      std::cerr << "rtree/grid mismatch: " << a.size() << " vs " << b.size()
+                << std::endl;
+      return 3;
+    }
+  }
+  Rectangle tb = tree.getBounds(), gb = grid.getBounds();
+  if (tb.getLeft() != gb.getLeft() || tb.getTop() != gb.getTop() ||
+      tb.getRight() != gb.getRight() || tb.getBottom() != gb.getBottom())
+    return 4;
+
+  // nearest: brute force over glyph boxes only
+  RectangleRTree<Rectangle> glyphs;
+  std::vector<Rectangle> small;
+  for (size_t i = 0; i < all.size(); ++i)
+    if (i % 100 != 0) {
+      small.push_back(all[i]);
+      glyphs.add(all[i]);
+    }
+  for (int i = 0; i < 200; ++i) {
+    float x = static_cast<float>(std::rand() % 700) - 50;
+    float y = static_cast<float>(std::rand() % 900) - 50;
+    size_t best = 0;
+    float bestD = -1;
+    for (size_t k = 0; k < small.size(); ++k) {
+      const Rectangle &r = small[k];
+      float dx = std::max(std::max(r.getLeft() - x, x - r.getRight()), 0.0f);
+      float dy = std::max(std::max(r.getTop() - y, y - r.getBottom()), 0.0f);
+      float dist = dx * dx + dy * dy;
+      if (bestD < 0 || dist < bestD) {
+        bestD = dist;
+        best = k;
+      }
+    }
+    if (glyphs.nearestId(x, y) != best) {
+      std::cerr << "nearest mismatch at " << x << "," << y << std::endl;
+      return 5;
+    }
+  }
+
+  // inserting after a query rebuilds the tree
+  tree.add(Rectangle(5000, 5000, 1, 1));
+  if (tree.queryIds(Rectangle(4999, 4999, 3, 3)).size() != 1 ||
+      tree.nearestId(5001, 5001) != all.size())
+    return 6;
+  return 0;
+}
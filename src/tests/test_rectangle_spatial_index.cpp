@@ -1,9 +1,16 @@
 #include "tabula/RectangleSpatialIndex.h"
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
 
 using namespace tabula;
 
+static bool overlaps(const Rectangle &r, const Rectangle &q) {
+  return !(r.getRight() < q.getLeft() || r.getLeft() > q.getRight() ||
+           r.getBottom() < q.getTop() || r.getTop() > q.getBottom());
+}
+
 int main() {
   RectangleSpatialIndex<Rectangle> si(10.0f);
   // insert some rectangles
@@ -15,6 +22,64 @@ int main() {
   Rectangle q(0, 0, 10, 10);
   auto res = si.query(q);
   assert(res.size() == 2);
+
+  // objects spanning many cells are reported once
+  si.add(Rectangle(0, 0, 25, 25));
+  if (si.queryIds(Rectangle(0, 0, 30, 30)).size() != 4)
+    return 2;
+  auto inside = si.containsIds(Rectangle(-1, -1, 13, 13));
+  std::sort(inside.begin(), inside.end());
+  if (inside != std::vector<size_t>({0, 2}))
+    return 3;
+  Rectangle bounds = si.getBounds();
+  if (bounds.getLeft() != 0 || bounds.getTop() != 0 ||
+      bounds.getRight() != 25 || bounds.getBottom() != 25)
+    return 4;
+
+  // adaptive cell size: compare against brute force on a scattered set,
+  // with queries inside, across and outside the bounds
+  RectangleSpatialIndex<Rectangle> adaptive;
+  std::vector<Rectangle> all;
+  std::srand(7);
+  for (int i = 0; i < 500; ++i) {
+    float top = static_cast<float>(std::rand() % 800);
+    float left = static_cast<float>(std::rand() % 600);
+    float w = static_cast<float>(1 + std::rand() % (i % 50 == 0 ? 300 : 20));
+    float h = static_cast<float>(1 + std::rand() % 15);
+    all.push_back(Rectangle(top, left, w, h));
+    adaptive.add(all.back());
+  }
+  for (int i = 0; i < 200; ++i) {
+    Rectangle area(static_cast<float>(std::rand() % 1000) - 100,
+                   static_cast<float>(std::rand() % 800) - 100,
+                   static_cast<float>(std::rand() % 200),
+                   static_cast<float>(std::rand() % 200));
+    std::vector<size_t> expected;
+    for (size_t k = 0; k < all.size(); ++k)
+      if (overlaps(all[k], area))
+        expected.push_back(k);
+    size_t visited = 0;
+    adaptive.forEach(area, [&](const Rectangle &r) {
+      if (overlaps(r, area))
+        ++visited;
+    });
+    auto got = adaptive.queryIds(area);
+    std::sort(got.begin(), got.end());
+    if (got != expected || visited != expected.size()) {
+      std::cerr << "adaptive query mismatch: got " << got.size()
+                << " expected " << expected.size() << std::endl;
+      return 5;
+    }
+  }
+
+  // inserting after a query rebuilds the grid; clear() empties it
+  adaptive.add(Rectangle(5000, 5000, 1, 1));
+  if (adaptive.queryIds(Rectangle(4999, 4999, 3, 3)).size() != 1)
+    return 6;
+  adaptive.clear();
+  if (!adaptive.query(Rectangle(0, 0, 1000, 1000)).empty())
+    return 7;
+
   std::cout << "test_rectangle_spatial_index: OK (hits=" << res.size() << ")\n";
   return 0;
 }
@@ -0,0 +1,76 @@
+#include "tabula/OrientedRuling.h"
+#include "tabula/RulingBuffer.h"
+#include "tabula/Utils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+using namespace tabula;
+
+template <typename R>
+static bool sameRulings(const std::vector<R> &a, const std::vector<R> &b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i)
+    if (a[i].position != b[i].position || a[i].start != b[i].start ||
+        a[i].end != b[i].end)
+      return false;
+  return true;
+}
+
+int main() {
+  // radix order matches a stable sort on the values, negatives included
+  std::srand(11);
+  std::vector<float> vals;
+  for (int i = 0; i < 1000; ++i)
+    vals.push_back(static_cast<float>(std::rand() % 2001 - 1000) / 8.0f);
+  std::vector<uint32_t> keys, order, expected;
+  for (size_t i = 0; i < vals.size(); ++i) {
+    keys.push_back(Utils::floatKey(vals[i]));
+    order.push_back(static_cast<uint32_t>(i));
+  }
+  expected = order;
+  std::stable_sort(expected.begin(), expected.end(),
+                   [&](uint32_t a, uint32_t b) { return vals[a] < vals[b]; });
+  Utils::radixSortIndices(keys, order);
+  if (order != expected)
+    return 2;
+
+  // a jittered grid of segments, snapped and collapsed both ways
+  std::vector<Ruling> rulings;
+  for (int i = 0; i < 300; ++i) {
+    float j = static_cast<float>(std::rand() % 5) * 0.3f;
+    float p = static_cast<float>(std::rand() % 30) * 10.0f + j;
+    float s = static_cast<float>(std::rand() % 280);
+    float e = s + 1 + std::rand() % 40;
+    if (i % 2)
+      rulings.push_back(Ruling(p, s, p, e));
+    else
+      rulings.push_back(Ruling(s, p, e, p));
+  }
+  for (float threshold : {0.0f, 2.0f}) {
+    std::vector<Ruling> snapped = rulings;
+    Utils::snapPoints(snapped, threshold, threshold);
+    std::vector<HorizontalRuling> hs;
+    std::vector<VerticalRuling> vs;
+    splitRulings(snapped, hs, vs);
+    hs = collapseRulings(hs);
+    vs = collapseRulings(vs);
+
+    RulingBuffer buffer;
+    buffer.assign(rulings);
+    buffer.snap(threshold, threshold);
+    std::vector<HorizontalRuling> bh;
+    std::vector<VerticalRuling> bv;
+    buffer.collapse(bh, bv);
+    if (!sameRulings(hs, bh) || !sameRulings(vs, bv)) {
+      std::cerr << "buffer collapse differs at threshold " << threshold
+                << ": " << bh.size() << "/" << hs.size() << " "
+                << bv.size() << "/" << vs.size() << std::endl;
+      return 3;
+    }
+    if (threshold > 0 && bv.size() >= 150)
+      return 4; // snapping should have joined segments
+  }
+  return 0;
+}
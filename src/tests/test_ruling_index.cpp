@@ -0,0 +1,72 @@
+#include "tabula/RulingIndex.h"
+#include <cstdlib>
+#include <iostream>
+
+using namespace tabula;
+
+static bool sameRulings(const std::vector<Ruling> &a,
+                        const std::vector<Ruling> &b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i)
+    if (a[i].getX1() != b[i].getX1() || a[i].getY1() != b[i].getY1() ||
+        a[i].getX2() != b[i].getX2() || a[i].getY2() != b[i].getY2())
+      return false;
+  return true;
+}
+
+int main() {
+  std::srand(17);
+  std::vector<Ruling> vs, hs;
+  for (int i = 0; i < 200; ++i) {
+    double x = std::rand() % 500, y = std::rand() % 500;
+    vs.push_back(Ruling(x, y, x, y + 1 + std::rand() % 80));
+    hs.push_back(Ruling(y, x, y + 1 + std::rand() % 80, x));
+  }
+  // a horizontal in the vertical list is ignored
+  vs.push_back(Ruling(0, 10, 500, 10));
+  VerticalRulingIndex vi(vs);
+  HorizontalRulingIndex hi(hs);
+  if (vi.size() != 200 || hi.size() != 200)
+    return 2;
+
+  for (int q = 0; q < 500; ++q) {
+    double lo = std::rand() % 500, hi2 = lo + std::rand() % 40;
+    double from = std::rand() % 500, to = from + std::rand() % 30;
+    // brute force, as mergeWords used to scan
+    bool expected = false;
+    for (const auto &r : vs) {
+      if (!r.vertical() || r.getLeft() <= lo || r.getLeft() >= hi2)
+        continue;
+      if (!(r.getBottom() < from || r.getTop() > to))
+        expected = true;
+    }
+    if (vi.anyBetween(lo, hi2, from, to) != expected) {
+      std::cerr << "anyBetween mismatch at query " << q << std::endl;
+      return 3;
+    }
+  }
+
+  // cropping matches Ruling::cropRulingsToArea on rulings in index order
+  std::vector<Ruling> sortedV = toRulings(vi.rulings());
+  std::vector<Ruling> sortedH = toRulings(hi.rulings());
+  for (int q = 0; q < 100; ++q) {
+    Rectangle area(std::rand() % 400, std::rand() % 400, 1 + std::rand() % 150,
+                   1 + std::rand() % 150);
+    if (!sameRulings(vi.cropToArea(area),
+                     Ruling::cropRulingsToArea(sortedV, area)) ||
+        !sameRulings(hi.cropToArea(area),
+                     Ruling::cropRulingsToArea(sortedH, area))) {
+      std::cerr << "crop mismatch at query " << q << std::endl;
+      return 4;
+    }
+  }
+
+  auto range = vi.positionRange(100, 200);
+  for (size_t i = range.first; i < range.second; ++i)
+    if (vi[i].position < 100 || vi[i].position > 200)
+      return 5;
+  if (range.first > 0 && vi[range.first - 1].position >= 100)
+    return 6;
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include "tabula/RulingIntersections.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+
+using namespace tabula;
+
+int main() {
+  std::srand(9);
+  std::vector<Ruling> hs, vs;
+  for (int i = 0; i < 60; ++i) {
+    double y = std::rand() % 400, x = std::rand() % 300;
+    hs.push_back(Ruling(x, y, x + 5 + std::rand() % 200, y));
+  }
+  for (int i = 0; i < 60; ++i) {
+    double x = std::rand() % 400, y = std::rand() % 300;
+    vs.push_back(Ruling(x, y, x, y + 5 + std::rand() % 200));
+  }
+  // a vertical that only reaches a horizontal through the 2pt expansion
+  hs.push_back(Ruling(500, 500, 600, 500));
+  vs.push_back(Ruling(601.5, 400, 601.5, 498.5));
+
+  // reference: every pair through Ruling::intersectionPoint, first wins
+  std::map<std::pair<double, double>, std::pair<size_t, size_t>> expected;
+  for (size_t h = 0; h < hs.size(); ++h)
+    for (size_t v = 0; v < vs.size(); ++v) {
+      auto p = hs[h].intersectionPoint(vs[v]);
+      if (!std::isnan(p.first))
+        expected.emplace(p, std::make_pair(h, v));
+    }
+
+  RulingIntersections ix(hs, vs);
+  if (ix.size() != expected.size()) {
+    std::cerr << "crossings: got " << ix.size() << " expected "
+              << expected.size() << std::endl;
+    return 2;
+  }
+  for (auto const &kv : expected) {
+    size_t i = ix.find(kv.first.first, kv.first.second);
+    if (i == RulingIntersections::npos)
+      return 3;
+    const auto &p = ix.points()[i];
+    if (p.x != kv.first.first || p.y != kv.first.second ||
+        p.h != kv.second.first || p.v != kv.second.second)
+      return 4;
+  }
+  if (ix.find(601.5, 500) == RulingIntersections::npos)
+    return 5;
+  if (ix.find(-1000, -1000) != RulingIntersections::npos)
+    return 6;
+  // the sweep only compares verticals inside each horizontal's span
+  if (ix.pairsTested() >= hs.size() * vs.size())
+    return 7;
+  return 0;
+}
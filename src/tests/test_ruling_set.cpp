@@ -0,0 +1,46 @@
+#include "tabula/Page.h"
+#include "tabula/RulingSet.h"
+#include <iostream>
+
+using namespace tabula;
+
+int main() {
+  Page page(1);
+  // two overlapping pieces of the same horizontal line plus two verticals
+  page.addRulings({Ruling(0, 10, 50, 10), Ruling(40, 10, 100, 10),
+                   Ruling(60, 0, 60, 40), Ruling(20, 0, 20, 40),
+                   Ruling(0, 0, 30, 90)}); // oblique: dropped
+  if (page.getUnprocessedRulings().size() != 4)
+    return 2;
+
+  // computed once and shared
+  auto set = page.getRulingSet();
+  if (page.getRulingSet() != set)
+    return 3;
+  const auto &hs = set->getHorizontalRulings();
+  const auto &vs = set->getVerticalRulings();
+  if (hs.size() != 1 || hs[0].getStart() != 0 || hs[0].getEnd() != 100)
+    return 4;
+  if (vs.size() != 2 || vs[0].getPosition() != 20 || vs[1].getPosition() != 60)
+    return 5;
+  if (set->getRulings().size() != 3 || !set->getRulings()[0].vertical() ||
+      !set->getRulings()[2].horizontal())
+    return 6;
+
+  // adding rulings starts a new set; the old one is left untouched
+  page.addRulings({Ruling(0, 30, 100, 30)});
+  auto next = page.getRulingSet();
+  if (next == set || next->getHorizontalRulings().size() != 2 ||
+      set->getHorizontalRulings().size() != 1)
+    return 7;
+  if (&page.getHorizontalRulings() != &next->getHorizontalRulings())
+    return 8;
+
+  // nothing accepted, nothing invalidated
+  page.addRulings({Ruling(5, 5, 5, 5)});
+  if (page.getRulingSet() != next) {
+    std::cerr << "ruling set rebuilt without new rulings" << std::endl;
+    return 9;
+  }
+  return 0;
+}
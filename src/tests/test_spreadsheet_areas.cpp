@@ -0,0 +1,53 @@
+#include "tabula/Page.h"
+#include "tabula/Ruling.h"
+#include "tabula/SpreadsheetExtractionAlgorithm.h"
+#include <iostream>
+
+using namespace tabula;
+
+static void addGrid(Page &page, float left, float top, int rows, int cols) {
+  for (int r = 0; r <= rows; ++r)
+    page.addRuling(Ruling(left, top + r * 20, left + cols * 40, top + r * 20));
+  for (int c = 0; c <= cols; ++c)
+    page.addRuling(Ruling(left + c * 40, top, left + c * 40, top + rows * 20));
+}
+
+int main() {
+  // two separate grids on one page: 2x3 at the top, 3x2 further down
+  Page page(1);
+  page.setLeft(0.0f);
+  page.setTop(0.0f);
+  page.setRight(600.0f);
+  page.setBottom(800.0f);
+  addGrid(page, 10, 10, 2, 3);
+  addGrid(page, 300, 200, 3, 2);
+
+  auto tables = SpreadsheetExtractionAlgorithm().extract(page);
+  if (tables.size() != 2) {
+    std::cerr << "expected 2 tables, got " << tables.size() << std::endl;
+    return 2;
+  }
+  const Rectangle &a = tables[0].getRect();
+  const Rectangle &b = tables[1].getRect();
+  if (a.getLeft() != 10 || a.getTop() != 10 || a.getWidth() != 120 ||
+      a.getHeight() != 40)
+    return 3;
+  if (b.getLeft() != 300 || b.getTop() != 200 || b.getWidth() != 80 ||
+      b.getHeight() != 60)
+    return 4;
+  if (tables[0].getRowCount() != 2 || tables[0].getColCount() != 3 ||
+      tables[1].getRowCount() != 3 || tables[1].getColCount() != 2) {
+    std::cerr << "unexpected table shapes" << std::endl;
+    return 5;
+  }
+
+  // cells meeting only at a corner still form one table
+  std::vector<Rectangle> diagonal = {Rectangle(0, 0, 10, 10),
+                                     Rectangle(10, 10, 10, 10),
+                                     Rectangle(50, 50, 10, 10)};
+  auto areas = SpreadsheetExtractionAlgorithm::findSpreadsheetsFromCells(diagonal);
+  if (areas.size() != 2 || areas[0].getWidth() != 20 ||
+      areas[1].getLeft() != 50)
+    return 6;
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include "tabula/Table.h"
+#include "tabula/TextStore.h"
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace tabula;
+
+static Cell textCell(const std::string &s) {
+  Cell c(0, 0, 10, 10);
+  c.addTextChunk(TextChunk(s, 0.0f, 0.0f));
+  return c;
+}
+
+int main() {
+  // rows of growing width keep their cells as the grid widens
+  Table t;
+  for (int r = 0; r < 50; ++r) {
+    std::vector<Cell> row;
+    for (int c = 0; c <= r % 7; ++c)
+      row.push_back(textCell(std::to_string(r) + ":" + std::to_string(c)));
+    t.addRow(std::move(row));
+  }
+  if (t.getRowCount() != 50 || t.getColCount() != 7)
+    return 2;
+  for (int r = 0; r < 50; ++r) {
+    Table::RowView row = t.getRow(r);
+    if (row.size() != 7)
+      return 3;
+    for (int c = 0; c < 7; ++c) {
+      bool added = c <= r % 7;
+      if (t.hasCell(r, c) != added ||
+          row[c].getText() !=
+              (added ? std::to_string(r) + ":" + std::to_string(c) : ""))
+        return 4;
+    }
+  }
+  // the nested copy matches the views
+  const auto &rows = t.getRows();
+  if (rows.size() != 50 || rows[13][5].getText() != "13:5" ||
+      !rows[14][1].getText().empty())
+    return 5;
+
+  // a second add at the same slot merges, and moved-in cells keep their
+  // store range instead of copying the text
+  std::shared_ptr<TextStore> store = std::make_shared<TextStore>();
+  store->add(TextElement(0, 0, 5, 5, std::string("w"), 1.0f));
+  Cell flat(0, 0, 10, 10);
+  flat.setText(store, TextStore::Range{0, 1});
+  t.add(std::move(flat), 0, 3);
+  t.add(textCell("more"), 0, 3);
+  if (t.getRow(0)[3].getText() != "wmore")
+    return 6;
+  Cell moved(0, 0, 10, 10);
+  moved.setText(store, TextStore::Range{0, 1});
+  t.add(std::move(moved), 2, 5);
+  if (!t.hasCell(2, 5) || t.getRow(2)[5].getTextStore() != store.get() ||
+      t.getRows()[2][5].getText() != "w")
+    return 7;
+
+  // a few cells far apart go to the map rather than a huge grid
+  Table sparse;
+  sparse.add(textCell("a"), 0, 0);
+  sparse.add(textCell("b"), 20000, 3);
+  sparse.add(textCell("c"), 20000, 3);
+  if (sparse.getRowCount() != 20001 || sparse.getColCount() != 4 ||
+      !sparse.hasCell(20000, 3) || sparse.hasCell(5, 0))
+    return 8;
+  if (sparse.getRow(0)[0].getText() != "a" ||
+      sparse.getRow(20000)[3].getText() != "bc" ||
+      !sparse.getRow(50)[2].getText().empty() || !sparse.getRow(20001).empty())
+    return 9;
+
+  // copies are independent
+  Table copy = t;
+  copy.add(textCell("x"), 60, 0);
+  if (t.getRowCount() != 50 || copy.getRowCount() != 61 ||
+      copy.getRow(13)[6].getText() != "13:6") {
+    std::cerr << "table copy shares state" << std::endl;
+    return 10;
+  }
+  return 0;
+}
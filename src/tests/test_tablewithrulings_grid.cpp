@@ -0,0 +1,116 @@
+#include "tabula/Cell.h"
+#include "tabula/Rectangle.h"
+#include "tabula/Ruling.h"
+#include "tabula/TableWithRulingLines.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace tabula;
+
+// Java's addCells start column, by brute force: the widest row among the
+// cells wholly below and to the left of `first`.
+static int startColumnOf(const Cell &first, const std::vector<Cell> &cells) {
+  std::vector<float> tops;
+  std::vector<int> counts;
+  for (auto const &c : cells) {
+    if (c.getTop() < first.getBottom() || c.getRight() > first.getLeft())
+      continue;
+    auto it = std::find(tops.begin(), tops.end(), c.getTop());
+    if (it == tops.end()) {
+      tops.push_back(c.getTop());
+      counts.push_back(1);
+    } else {
+      ++counts[it - tops.begin()];
+    }
+  }
+  int best = 0;
+  for (int n : counts)
+    best = std::max(best, n);
+  return best;
+}
+
+int main() {
+  // a 2 x 2 block in a 3 x 3 ruled grid: spans recorded on the anchor,
+  // placeholders laid out with the anchor's top and height
+  Rectangle area{0, 0, 150, 150};
+  std::vector<Ruling> hr, vr;
+  for (int k = 0; k <= 3; ++k) {
+    hr.emplace_back(0.0, 50.0 * k, 150.0, 50.0 * k);
+    vr.emplace_back(50.0 * k, 0.0, 50.0 * k, 150.0);
+  }
+  std::vector<Cell> cells;
+  cells.emplace_back(0.0f, 0.0f, 100.0f, 100.0f);
+  cells.emplace_back(0.0f, 100.0f, 50.0f, 50.0f);
+  cells.emplace_back(100.0f, 0.0f, 50.0f, 50.0f);
+  cells.back().addTextChunk(TextChunk("x", 110.0f, 10.0f));
+  // lands on a placeholder slot of the block and takes it over
+  cells.emplace_back(50.0f, 50.0f, 50.0f, 50.0f);
+  TableWithRulingLines t(area, std::move(cells), hr, vr, 4);
+  if (t.getRowCount() != 3 || t.getColCount() != 3 || t.getPageNumber() != 4)
+    return 2;
+  const Cell &anchor = t.getRow(0)[0];
+  if (!anchor.isSpanning() || anchor.getRowSpan() != 2 ||
+      anchor.getColSpan() != 2 || anchor.isPlaceholder())
+    return 3;
+  const Cell &single = t.getRow(0)[2];
+  if (single.isSpanning() || single.getRowSpan() != 1 ||
+      single.getColSpan() != 1)
+    return 4;
+  const Cell &ph = t.getRow(1)[0];
+  if (!ph.isPlaceholder() || ph.getTop() != 0.0f || ph.getLeft() != 0.0f ||
+      ph.getWidth() != 50.0f || ph.getHeight() != 100.0f)
+    return 5;
+  const Cell &merged = t.getRow(1)[1];
+  if (!merged.isPlaceholder() || merged.getTop() != 0.0f ||
+      merged.getLeft() != 50.0f || merged.getBottom() != 100.0f)
+    return 6;
+  if (t.getRow(2)[0].getText() != "x" || t.hasCell(2, 2))
+    return 7;
+
+  // a placeholder over an occupied slot only grows it
+  Table grid;
+  Cell occupied(10.0f, 10.0f, 5.0f, 5.0f);
+  occupied.addTextChunk(TextChunk("y", 10.0f, 10.0f));
+  grid.add(occupied, 0, 0);
+  grid.addPlaceholder(Rectangle(0.0f, 0.0f, 12.0f, 12.0f), 0, 0);
+  const Cell &grown = grid.getRow(0)[0];
+  if (grown.isPlaceholder() || grown.getText() != "y" ||
+      grown.getTop() != 0.0f || grown.getRight() != 15.0f)
+    return 8;
+
+  // without rulings, staggered rows start after the widest row below and
+  // to the left of them
+  std::srand(7);
+  std::mt19937 shuffler(7);
+  for (int round = 0; round < 20; ++round) {
+    std::vector<Cell> loose;
+    for (int r = 0; r < 12; ++r) {
+      const int n = 1 + std::rand() % 4;
+      float left = static_cast<float>(std::rand() % 40);
+      for (int k = 0; k < n; ++k) {
+        loose.emplace_back(static_cast<float>(10 * r), left, 10.0f, 10.0f);
+        left += 10.0f + static_cast<float>(std::rand() % 3);
+      }
+    }
+    std::shuffle(loose.begin(), loose.end(), shuffler);
+    TableWithRulingLines f(Rectangle(0, 0, 200, 200), loose,
+                           std::vector<Ruling>{}, std::vector<Ruling>{}, 0);
+    if (f.getRowCount() != 12)
+      return 9;
+    for (int r = 0; r < f.getRowCount(); ++r) {
+      Table::RowView row = f.getRow(r);
+      int c = 0;
+      while (c < static_cast<int>(row.size()) && !f.hasCell(r, c))
+        ++c;
+      if (c == static_cast<int>(row.size()) ||
+          c != startColumnOf(row[c], loose)) {
+        std::cerr << "row " << r << " starts at column " << c << std::endl;
+        return 10;
+      }
+    }
+  }
+  return 0;
+}
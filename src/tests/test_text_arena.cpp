@@ -0,0 +1,98 @@
+#include "tabula/ObjectExtractor.h"
+#include "tabula/PageSnapshot.h"
+#include "tabula/TextArena.h"
+#include "tabula/TextChunk.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace tabula;
+
+int main() {
+  // views stay valid while the arena grows block by block
+  TextArena arena(64);
+  std::vector<TextView> views;
+  for (int i = 0; i < 200; ++i)
+    views.push_back(arena.append("glyph" + std::to_string(i)));
+  if (arena.blockCount() < 2)
+    return 2;
+  for (int i = 0; i < 200; ++i)
+    if (views[i].str() != "glyph" + std::to_string(i))
+      return 3;
+
+  // a string built from parts stays contiguous across a block boundary
+  std::string expected;
+  for (int i = 0; i < 30; ++i) {
+    arena.appendPart(views[i]);
+    arena.appendPart(' ');
+    expected += views[i].str() + " ";
+  }
+  TextView joined = arena.finish();
+  if (joined.str() != expected || views[0].str() != "glyph0")
+    return 4;
+  if (arena.append(std::string()).data() == nullptr || !arena.finish().empty())
+    return 5;
+
+  // elements over the arena copy and read like owning ones
+  TextElement owned(0, 0, 10, 8, std::string("ab"), 2.0f);
+  TextElement viewed(0, 0, 10, 8, arena.append("ab"), 2.0f);
+  TextElement copy = viewed;
+  if (copy.getText() != owned.getText() ||
+      copy.getTextView().data() != viewed.getTextView().data())
+    return 6;
+  TextChunk chunk;
+  chunk.add(TextElement(0, 0, 90, 10, arena.append("aaa---bbb"), 1.0f));
+  std::vector<TextChunk> parts = chunk.squeeze('-', 3, &arena);
+  if (parts.size() != 2 || parts[0].getText() != "aaa" ||
+      parts[1].getText() != "bbb")
+    return 7;
+
+  // the snapshot's text goes into one arena that the page keeps alive
+  PageSnapshot snap;
+  const char *words[] = {"alpha", "a considerably longer text box", "gamma"};
+  for (int i = 0; i < 3; ++i) {
+    PageSnapshot::TextBox b;
+    b.top = 10.0f * i;
+    b.left = 0;
+    b.width = 40;
+    b.height = 8;
+    b.text = words[i];
+    snap.boxes.push_back(b);
+  }
+  std::weak_ptr<const TextArena> released;
+  std::vector<TextElement> kept;
+  {
+    Page page;
+    {
+      std::shared_ptr<TextArena> pageArena = std::make_shared<TextArena>();
+      std::vector<TextElement> elems = snap.toTextElements(*pageArena);
+      if (elems.size() != 3 || elems[1].getText() != words[1] ||
+          pageArena->bytesUsed() != 5 + 30 + 5)
+        return 8;
+      ObjectExtractor oe(nullptr, elems);
+      oe.setTextArena(pageArena);
+      page = oe.extractPage(1);
+      released = pageArena;
+    }
+    if (released.expired() || page.getTextArena() != released.lock() ||
+        page.getTextChunks().size() != 3 ||
+        page.getTextChunks()[1].getText() != words[1])
+      return 9;
+    kept = page.getTextElementsOverlapping(Rectangle(0, 0, 40, 30));
+    if (kept.size() != 3 || kept[1].viewsArena() ||
+        !page.getTextElement(1).viewsArena())
+      return 11;
+  }
+  if (!released.expired()) {
+    std::cerr << "page arena outlived the page" << std::endl;
+    return 10;
+  }
+  // the overlapping elements own their text and outlive the page
+  if (kept[0].getText() != words[0] || kept[1].getText() != words[1])
+    return 12;
+  kept[2].setText("delta");
+  if (kept[2].getText() != "delta")
+    return 13;
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include "tabula/Page.h"
+#include "tabula/TextLayout.h"
+#include <cstdlib>
+#include <iostream>
+
+using namespace tabula;
+
+static bool sameChunks(const std::vector<TextChunk> &a,
+                       const std::vector<TextChunk> &b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i)
+    if (a[i].getText() != b[i].getText() || a[i].getLeft() != b[i].getLeft() ||
+        a[i].getTop() != b[i].getTop() || a[i].getWidth() != b[i].getWidth() ||
+        a[i].getHeight() != b[i].getHeight())
+      return false;
+  return true;
+}
+
+int main() {
+  // glyphs on a few baselines, with word gaps and a ruling through a line
+  std::srand(21);
+  Page page(1);
+  std::vector<TextElement> all;
+  for (int line = 0; line < 6; ++line) {
+    TextChunk chunk;
+    float x = 0;
+    for (int g = 0; g < 30; ++g) {
+      float y = line * 12.0f + static_cast<float>(std::rand() % 3) * 0.5f;
+      TextElement te(y, x, 5.0f, 8.0f, std::string(1, char('a' + g % 26)),
+                     2.0f);
+      chunk.add(te);
+      all.push_back(te);
+      x += (std::rand() % 5 == 0) ? 9.0f : 5.5f;
+    }
+    page.addTextChunk(chunk);
+  }
+  VerticalRulingIndex rulings(std::vector<Ruling>{Ruling(40.2, 0, 40.2, 30)});
+
+  const TextLayout &layout = page.getTextLayout();
+  if (layout.size() != all.size())
+    return 2;
+
+  // grouping selected ids matches merging copies of the same elements
+  for (int q = 0; q < 40; ++q) {
+    Rectangle cell(static_cast<float>(std::rand() % 60),
+                   static_cast<float>(std::rand() % 150),
+                   static_cast<float>(10 + std::rand() % 60),
+                   static_cast<float>(5 + std::rand() % 30));
+    std::vector<uint32_t> ids = page.getTextElementIdsOverlapping(cell);
+    std::vector<TextElement> elems = page.getTextElementsOverlapping(cell);
+    if (ids.size() != elems.size())
+      return 3;
+    if (!sameChunks(layout.mergeWords(ids, &rulings),
+                    TextChunk::mergeWords(elems, &rulings)))
+      return 4;
+  }
+
+  // whole lines: words split on the wider gaps and at the ruling
+  std::vector<uint32_t> firstLine;
+  for (uint32_t i = 0; i < 30; ++i)
+    firstLine.push_back(i);
+  TextLayout::Grouping g;
+  layout.group(firstLine, &rulings, g);
+  if (g.lines.size() != 1 || g.words.size() < 2)
+    return 5;
+  for (const auto &w : g.words)
+    for (uint32_t i = w.begin + 1; i < w.end; ++i)
+      if (layout.element(g.ids[i - 1]).getRight() < 40.2f &&
+          layout.element(g.ids[i]).getLeft() > 40.2f)
+        return 6; // the ruling runs between two glyphs of one word
+
+  // the layout owns its text, so a copied page can share it
+  Page copy = page;
+  if (&copy.getTextLayout() != &layout ||
+      copy.getTextStore()->text(0) != all[0].getText())
+    return 7;
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include "tabula/Cell.h"
+#include "tabula/Page.h"
+#include "tabula/Table.h"
+#include "tabula/TextLayout.h"
+#include "tabula/TextStore.h"
+#include <iostream>
+#include <memory>
+
+using namespace tabula;
+
+int main() {
+  // flat store: text of each element is a slice of one byte array
+  TextStore store;
+  uint32_t a = store.add(TextElement(10, 5, 4, 8, "ab", 2.0f));
+  store.appendText("c", 1);
+  store.appendText(' ');
+  store.appendText(store, a);
+  uint32_t b = store.addElement(TextStore::Box{10, 20, 12, 8});
+  if (store.size() != 2 || store.text(a) != "ab" || store.text(b) != "c ab")
+    return 2;
+  TextElement te = store.element(a);
+  if (te.getLeft() != 5 || te.getWidth() != 4 || te.getWidthOfSpace() != 2.0f)
+    return 3;
+
+  // a cell over a range of words reads the same as one owning the chunks
+  Page page(1);
+  TextChunk line;
+  const char *glyphs[] = {"t", "w", "o", "w", "o", "r", "d", "s"};
+  float x = 0;
+  for (int i = 0; i < 8; ++i) {
+    line.add(TextElement(0, x, 4, 8, glyphs[i], 2.0f));
+    x += i == 2 ? 10.0f : 4.5f;
+  }
+  page.addTextChunk(line);
+  page.addTextChunk(TextChunk(TextElement(12, 0, 4, 8, "z", 2.0f)));
+
+  const TextLayout &layout = page.getTextLayout();
+  Cell area(0, 0, 60, 30);
+  std::vector<uint32_t> ids = page.getTextElementIdsOverlapping(area);
+  TextLayout::Grouping g;
+  layout.group(ids, nullptr, g);
+  std::shared_ptr<TextStore> words = std::make_shared<TextStore>();
+  Cell flat = area;
+  flat.setText(words, layout.appendWords(g, *words));
+  Cell owned = area;
+  owned.setTextElements(layout.wordChunks(g));
+  if (flat.getTextRange().size() != 3 || words->text(0) != "t w o" ||
+      flat.getText() != owned.getText() || flat.getText() != "t w ow o r d s\rz")
+    return 4;
+  const Cell &view = flat;
+  std::vector<TextChunk> chunks = view.getTextElements();
+  if (chunks.size() != 3 || chunks[1].getText() != "w o r d s" ||
+      chunks[1].getLeft() != owned.getTextElements()[1].getLeft())
+    return 5;
+
+  // tables copy the range, not the text
+  Table t;
+  t.add(flat, 0, 0);
+  Table copy = t;
+  const Cell &placed = copy.getRows()[0][0];
+  if (placed.getTextStore() != words.get() || placed.getText() != flat.getText())
+    return 6;
+
+  // merging neighbouring ranges of one store keeps the cell flat
+  Cell first = area, second = area;
+  first.setText(words, TextStore::Range{0, 1});
+  second.setText(words, TextStore::Range{1, 3});
+  t.add(first, 1, 0);
+  t.add(second, 1, 0);
+  const Cell &merged = t.getRows()[1][0];
+  if (merged.getTextStore() != words.get() || merged.getTextRange().size() != 3)
+    return 7;
+  // anything else falls back to owned chunks, in the same order
+  Cell chunked = area;
+  chunked.addTextChunk(TextChunk(TextElement(20, 0, 4, 8, "q", 2.0f)));
+  t.add(second, 2, 0);
+  t.add(chunked, 2, 0);
+  const Cell &mixed = t.getRows()[2][0];
+  if (mixed.getTextStore() || mixed.getTextElements().size() != 3 ||
+      mixed.getText() != "w o r d s\rz\rq") {
+    std::cerr << "mixed merge: " << mixed.getText() << std::endl;
+    return 8;
+  }
+
+  // handing out the chunks for editing turns the cell into an owning one
+  Cell edited = flat;
+  edited.getTextElements().pop_back();
+  if (edited.getTextStore() || edited.getText() != "t w ow o r d s" ||
+      flat.getTextStore() != words.get())
+    return 9;
+
+  // through a base reference a store-backed cell reads and merges the same
+  Cell viewed = flat;
+  const std::string before = viewed.text();
+  RectangularTextContainer<TextChunk> &base = viewed;
+  if (base.getTextElements().size() != flat.getTextRange().size() ||
+      base.getText() != before)
+    return 10;
+  TextChunk extra(TextElement(90, 0, 4, 8, "!", 2.0f));
+  Cell bare(80, 0, 10, 20);
+  bare.addTextChunk(extra);
+  base.merge(static_cast<const RectangularTextContainer<TextChunk> &>(bare));
+  if (viewed.getTextStore() || viewed.text() != before + "\r!" ||
+      viewed.getBottom() != 100.0f) {
+    std::cerr << "base merge: " << viewed.text() << std::endl;
+    return 11;
+  }
+  return 0;
+}
@@ -0,0 +1,59 @@
+#include "tabula/Trace.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+static size_t countOf(const std::string &s, const std::string &needle) {
+  size_t n = 0;
+  for (size_t pos = s.find(needle); pos != std::string::npos;
+       pos = s.find(needle, pos + 1))
+    ++n;
+  return n;
+}
+
+int main() {
+  using namespace tabula;
+
+  // nothing is recorded while tracing is off
+  {
+    TABULA_TRACE_SCOPE("ignored");
+  }
+  Trace::start();
+  {
+    TABULA_TRACE_SCOPE("page", 3);
+    TABULA_TRACE_SCOPE("findCells");
+  }
+  std::thread worker([]() { TABULA_TRACE_SCOPE("page", 4); });
+  worker.join();
+  Trace::stop();
+  {
+    TABULA_TRACE_SCOPE("ignored");
+  }
+
+  std::ostringstream out;
+  Trace::writeJson(out);
+  const std::string json = out.str();
+  if (json.find("{\"traceEvents\":[") != 0) {
+    std::cerr << "unexpected trace header: " << json << std::endl;
+    return 2;
+  }
+  if (countOf(json, "\"ph\":\"X\"") != 3 ||
+      json.find("ignored") != std::string::npos) {
+    std::cerr << "unexpected trace events: " << json << std::endl;
+    return 3;
+  }
+  if (json.find("\"name\":\"findCells\"") == std::string::npos ||
+      json.find("\"args\":{\"page\":3}") == std::string::npos ||
+      json.find("\"args\":{\"page\":4}") == std::string::npos) {
+    std::cerr << "missing span names or page args: " << json << std::endl;
+    return 4;
+  }
+  // the worker thread gets its own track
+  if (json.find("\"tid\":1") == std::string::npos ||
+      json.find("\"tid\":2") == std::string::npos) {
+    std::cerr << "expected two thread ids: " << json << std::endl;
+    return 5;
+  }
+  return 0;
+}
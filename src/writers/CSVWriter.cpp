@@ -4,7 +4,10 @@
 namespace tabula {
 namespace writers {
 
-static std::string escapeCSV(const std::string &s, char delim) {
+// Writes `s` as one field, quoted when it holds a quote, a line break or
+// the delimiter.
+static void writeCSVField(std::ostream &out, const std::string &s,
+                          char delim) {
   bool needQuotes = false;
   for (char c : s) {
     if (c == '"' || c == '\n' || c == '\r' || c == delim) {
@@ -12,65 +15,88 @@ static std::string escapeCSV(const std::string &s, char delim) {
       break;
     }
   }
-  if (!needQuotes)
-    return s;
-  std::string out;
-  out.push_back('"');
-  for (char c : s) {
-    if (c == '"')
-      out.push_back('"');
-    out.push_back(c);
+  if (!needQuotes) {
+    out.write(s.data(), static_cast<std::streamsize>(s.size()));
+    return;
+  }
+  out.put('"');
+  size_t from = 0;
+  for (size_t i = 0; i < s.size(); ++i) {
+    if (s[i] != '"')
+      continue;
+    // write up to and including the quote, then double it
+    out.write(s.data() + from, static_cast<std::streamsize>(i + 1 - from));
+    out.put('"');
+    from = i + 1;
   }
-  out.push_back('"');
-  return out;
+  out.write(s.data() + from, static_cast<std::streamsize>(s.size() - from));
+  out.put('"');
 }
 
 void CSVWriter::write(std::ostream &out, const Table &table) const {
-  write(out, std::vector<Table>{table});
+  writeOne(out, table, true);
 }
 
 void CSVWriter::write(std::ostream &out,
                       const std::vector<Table> &tables) const {
   bool firstTable = true;
   for (auto const &t : tables) {
-    if (!firstTable) {
-      // separate multiple tables by an empty line
-      out << "\n";
-    }
+    writeOne(out, t, firstTable);
     firstTable = false;
-    // optional header row
-    if (includeHeaderRow) {
-      bool first = true;
-      if (includePageNumber) {
-        out << "page";
-        first = false;
-      }
-      for (auto const &colHeader : t.getColumnHeaders()) {
-        if (!first) {
-          out << delim;
-        }
-        first = false;
-        out << escapeCSV(colHeader, delim);
-      }
-      out << "\n";
+  }
+}
+
+void CSVWriter::begin(std::ostream &out) {
+  (void)out;
+  tablesWritten = 0;
+}
+
+void CSVWriter::writeTable(std::ostream &out, const Table &table) {
+  writeOne(out, table, tablesWritten == 0);
+  ++tablesWritten;
+}
+
+void CSVWriter::end(std::ostream &out) { (void)out; }
+
+void CSVWriter::writeOne(std::ostream &out, const Table &t,
+                         bool firstTable) const {
+  if (!firstTable) {
+    // separate multiple tables by an empty line
+    out << "\n";
+  }
+  // optional header row
+  if (includeHeaderRow) {
+    bool first = true;
+    if (includePageNumber) {
+      out << "page";
+      first = false;
     }
-    for (auto const &row : t.getRows()) {
-      bool first = true;
-      // optionally write page number as first column
-      if (includePageNumber) {
-        out << t.getPageNumber();
-        if (!row.empty())
-          out << delim;
+    for (auto const &colHeader : t.getColumnHeaders()) {
+      if (!first) {
+        out << delim;
       }
-      for (auto const &cell : row) {
-        if (!first) {
-          out << delim;
-        }
-        first = false;
-        out << escapeCSV(cell.getText(), delim);
+      first = false;
+      writeCSVField(out, colHeader, delim);
+    }
+    out << "\n";
+  }
+  for (int r = 0; r < t.getRowCount(); ++r) {
+    const Table::RowView row = t.getRow(r);
+    bool first = true;
+    // optionally write page number as first column
+    if (includePageNumber) {
+      out << t.getPageNumber();
+      if (!row.empty())
+        out << delim;
+    }
+    for (auto const &cell : row) {
+      if (!first) {
+        out << delim;
       }
-      out << "\n";
+      first = false;
+      writeCSVField(out, cell.text(), delim);
     }
+    out << "\n";
   }
 }
 
@@ -6,7 +6,7 @@ namespace tabula {
 namespace writers {
 
 void JSONWriter::write(std::ostream &out, const Table &table) const {
-  write(out, std::vector<Table>{table});
+  out << "[" << tabula::json::serializeTable(table) << "]";
 }
 
 void JSONWriter::write(std::ostream &out,
@@ -22,5 +22,19 @@ void JSONWriter::write(std::ostream &out,
   out << "]";
 }
 
+void JSONWriter::begin(std::ostream &out) {
+  out << "[";
+  tablesWritten = 0;
+}
+
+void JSONWriter::writeTable(std::ostream &out, const Table &table) {
+  if (tablesWritten > 0)
+    out << ",";
+  out << tabula::json::serializeTable(table);
+  ++tablesWritten;
+}
+
+void JSONWriter::end(std::ostream &out) { out << "]"; }
+
 } // namespace writers
 } // namespace tabula